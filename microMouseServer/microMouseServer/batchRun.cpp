@@ -0,0 +1,45 @@
+#include "batchRun.h"
+
+runOptions::runOptions() :
+    startX(0),
+    startY(0),
+    startDir(dUP),
+    maxTicks(100000),
+    stopAtGoal(false),
+    timeLimitS(-1)
+{
+}
+
+runSummary runMaze(std::shared_ptr<const mazeLayout> layout, mouseAI &ai, const runOptions &options,
+                   runRecorder &recorder, const std::string &mazeName, const std::string &aiName,
+                   aiListener *listener)
+{
+    simState sim(layout);
+    if(options.startX > 0 && options.startY > 0)
+    {
+        sim.reset(options.startX, options.startY, options.startDir);
+    }
+    recorder.begin(sim, mazeName, aiName);
+    ai.attach(&sim, &recorder, listener);
+
+    while(!sim.isFinished() && sim.mouse().ticks < options.maxTicks)
+    {
+        ai.step();
+        if(options.timeLimitS >= 0 && recorder.motionTime() > options.timeLimitS)
+        {
+            break;
+        }
+        if(options.stopAtGoal && !sim.isFinished() && sim.isAtGoal())
+        {
+            sim.finish();
+            recorder.record(sim, aFINISH);
+            if(listener)
+            {
+                listener->finished(sim);
+            }
+        }
+    }
+
+    ai.attach(0);
+    return recorder.finish(sim);
+}
@@ -0,0 +1,28 @@
+#ifndef BATCHRUN_H
+#define BATCHRUN_H
+
+#include "mouseAI.h"
+#include "runStats.h"
+#include <memory>
+#include <string>
+
+struct runOptions
+{
+    int startX, startY; //0 starts from the pose stored with the maze
+    mDirection startDir;
+    long maxTicks;      //give up after this many calls to studentAI()
+    bool stopAtGoal;    //end the run as soon as the mouse enters the goal
+    double timeLimitS;  //give up once the run takes this many kinematic seconds, -1 for no limit
+
+    runOptions();
+};
+
+/*
+ * Runs one AI on one maze as fast as possible, no timer and no drawing.
+ * The recorder is reset for the run and keeps its step log afterwards.
+ */
+runSummary runMaze(std::shared_ptr<const mazeLayout> layout, mouseAI &ai, const runOptions &options,
+                   runRecorder &recorder, const std::string &mazeName, const std::string &aiName,
+                   aiListener *listener = 0);
+
+#endif // BATCHRUN_H
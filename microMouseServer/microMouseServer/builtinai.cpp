@@ -0,0 +1,51 @@
+#include "builtinai.h"
+#include "studentai.h"
+
+wallFollower::wallFollower(bool leftHand) :
+    _leftHand(leftHand)
+{
+}
+
+void wallFollower::studentAI()
+{
+    bool openSide = _leftHand ? !isWallLeft() : !isWallRight();
+    if(openSide)
+    {
+        if(_leftHand) turnLeft(); else turnRight();
+        moveForward();
+    }
+    else if(!isWallForward())
+    {
+        moveForward();
+    }
+    else
+    {
+        if(_leftHand) turnRight(); else turnLeft();
+    }
+}
+
+std::vector<std::string> aiNames()
+{
+    std::vector<std::string> names;
+    names.push_back("student");
+    names.push_back("left");
+    names.push_back("right");
+    return names;
+}
+
+mouseAI *createAI(const std::string &name)
+{
+    if(name == "student")
+    {
+        return new studentMouse;
+    }
+    else if(name == "left")
+    {
+        return new wallFollower(true);
+    }
+    else if(name == "right")
+    {
+        return new wallFollower(false);
+    }
+    return 0;
+}
@@ -0,0 +1,24 @@
+#ifndef BUILTINAI_H
+#define BUILTINAI_H
+
+#include "mouseAI.h"
+#include <string>
+#include <vector>
+
+//follows one wall by hand, finds the goal in any maze without islands around it
+class wallFollower : public mouseAI
+{
+public:
+    explicit wallFollower(bool leftHand = true);
+    void studentAI();
+    unsigned long long stateHash() const { return 0; }
+
+private:
+    bool _leftHand;
+};
+
+//every AI that can be picked by name, "student" is studentai.cpp
+std::vector<std::string> aiNames();
+mouseAI *createAI(const std::string &name);
+
+#endif // BUILTINAI_H
@@ -0,0 +1,474 @@
+/*
+ * Headless runner, no Qt and no window. Runs one AI over any number of .maz
+ * files and prints a line of results per maze.
+ */
+#include "batchRun.h"
+#include "builtinai.h"
+#include "competition.h"
+#include "mazeFile.h"
+#include "motionScore.h"
+#include "pathPlanner.h"
+#include "resultCache.h"
+#include "spectator.h"
+#include "sweep.h"
+#include <charconv>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct cliOptions
+{
+    std::string ai;
+    std::string statsDir;
+    std::string cacheFile;
+    std::string spectate;
+    bool quiet;
+    bool session;
+    bool sweep;
+    int threads;
+    runOptions run;
+    sessionRules rules;
+    motionConfig motion;
+    plannerCosts costs;
+    std::vector<std::string> mazes;
+
+    cliOptions() : ai("student"), quiet(false), session(false), sweep(false), threads(0) {}
+};
+
+//prints printUI output as it happens unless -q was given, and passes everything on to the spectators
+class cliListener : public aiListener
+{
+public:
+    cliListener(bool quiet, aiListener *next) : _quiet(quiet), _next(next) {}
+
+    void mouseMoved(const simState &state)
+    {
+        if(_next)
+        {
+            _next->mouseMoved(state);
+        }
+    }
+
+    void printed(const simState &state, const char *mesg)
+    {
+        if(!_quiet)
+        {
+            printf("  [%ld] %s\n", state.mouse().ticks, mesg);
+        }
+        if(_next)
+        {
+            _next->printed(state, mesg);
+        }
+    }
+
+    void finished(const simState &state)
+    {
+        if(_next)
+        {
+            _next->finished(state);
+        }
+    }
+
+private:
+    bool _quiet;
+    aiListener *_next;
+};
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options] maze.maz [maze.maz ...]\n"
+            "  --ai NAME         AI to run:", name);
+    std::vector<std::string> names = aiNames();
+    for(size_t i = 0; i < names.size(); i++)
+    {
+        fprintf(stderr, " %s", names[i].c_str());
+    }
+    fprintf(stderr, " (default student)\n"
+            "  --max-ticks N     give up after N calls to studentAI() (default 100000)\n"
+            "  --stop-at-goal    end the run when the mouse enters the goal\n"
+            "  --stats DIR       append runs/steps .csv and .mcol files to DIR\n"
+            "  --cache FILE      reuse results of earlier identical runs kept in FILE, a\n"
+            "                    reused run gets a --stats runs row but no steps\n"
+            "  --cell M --speed V --accel A --turn S\n"
+            "                    kinematic scoring: cell size in m, top speed in m/s,\n"
+            "                    acceleration in m/s^2 and seconds per turn\n"
+            "  --no-diagonals    plan speed runs without 45 degree moves\n"
+            "  --session N       competition session of up to N runs (search run plus speed\n"
+            "                    runs) with the same AI, the result cache is not used\n"
+            "  --budget S        kinematic seconds for the whole session (default 600)\n"
+            "  --sweep           run from every cell and heading, print how many headings\n"
+            "                    reach the goal from each cell and their mean steps\n"
+            "  --threads N       threads for --sweep (default one per core)\n"
+            "  --spectate PATH   stream the runs to microMouseViewer on Unix socket PATH,\n"
+            "                    waits for the first viewer before starting\n"
+            "  -q                only print results\n");
+}
+
+//the whole of text has to be a number above 0, a divide by a zero speed would put inf in the stats
+template <class T>
+static bool parsePositive(const std::string &arg, const char *text, T &val)
+{
+    const char *end = text + strlen(text);
+    std::from_chars_result res = std::from_chars(text, end, val);
+    if(res.ec != std::errc() || res.ptr != end || !(val > 0))
+    {
+        fprintf(stderr, "%s needs a number greater than 0, not \"%s\"\n", arg.c_str(), text);
+        return false;
+    }
+    return true;
+}
+
+static bool parseArgs(int argc, char *argv[], cliOptions &opts)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if(arg == "-q")
+        {
+            opts.quiet = true;
+        }
+        else if(arg == "--stop-at-goal")
+        {
+            opts.run.stopAtGoal = true;
+        }
+        else if(arg == "--sweep")
+        {
+            opts.sweep = true;
+        }
+        else if(arg == "--no-diagonals")
+        {
+            opts.costs.diagonals = false;
+        }
+        else if(arg == "--ai" && hasValue)
+        {
+            opts.ai = argv[++i];
+        }
+        else if(arg == "--stats" && hasValue)
+        {
+            opts.statsDir = argv[++i];
+        }
+        else if(arg == "--spectate" && hasValue)
+        {
+            opts.spectate = argv[++i];
+        }
+        else if(arg == "--cache" && hasValue)
+        {
+            opts.cacheFile = argv[++i];
+        }
+        else if(arg == "--max-ticks" && hasValue)
+        {
+            if(!parsePositive(arg, argv[++i], opts.run.maxTicks))
+            {
+                return false;
+            }
+            opts.rules.maxTicksPerRun = opts.run.maxTicks;
+        }
+        else if(arg == "--session" && hasValue)
+        {
+            opts.session = true;
+            if(!parsePositive(arg, argv[++i], opts.rules.maxRuns))
+            {
+                return false;
+            }
+        }
+        else if(arg == "--threads" && hasValue)
+        {
+            if(!parsePositive(arg, argv[++i], opts.threads))
+            {
+                return false;
+            }
+        }
+        else if(arg == "--budget" && hasValue)
+        {
+            if(!parsePositive(arg, argv[++i], opts.rules.totalTimeS))
+            {
+                return false;
+            }
+        }
+        else if(arg == "--cell" && hasValue)
+        {
+            if(!parsePositive(arg, argv[++i], opts.motion.cellSize))
+            {
+                return false;
+            }
+        }
+        else if(arg == "--speed" && hasValue)
+        {
+            if(!parsePositive(arg, argv[++i], opts.motion.maxSpeed))
+            {
+                return false;
+            }
+        }
+        else if(arg == "--accel" && hasValue)
+        {
+            if(!parsePositive(arg, argv[++i], opts.motion.accel))
+            {
+                return false;
+            }
+        }
+        else if(arg == "--turn" && hasValue)
+        {
+            if(!parsePositive(arg, argv[++i], opts.motion.turnPenalty))
+            {
+                return false;
+            }
+        }
+        else if(arg.size() > 1 && arg[0] == '-')
+        {
+            return false;
+        }
+        else
+        {
+            opts.mazes.push_back(arg);
+        }
+    }
+    return !opts.mazes.empty();
+}
+
+static std::string statsPath(const std::string &dir, const char *name)
+{
+    if(dir.empty() || dir[dir.size()-1] == '/')
+    {
+        return dir + name;
+    }
+    return dir + "/" + name;
+}
+
+//the AIs are compiled in, so the running executable is the AI binary
+static std::string selfPath(const char *argv0)
+{
+#ifdef __linux__
+    (void)argv0;
+    return "/proc/self/exe";
+#else
+    return argv0;
+#endif
+}
+
+static void printRun(const std::string &name, const runSummary &summary, bool cached)
+{
+    printf("%s\t%d\t%ld\t%ld\t%ld\t%ld\t%d\t%.3f\t%.2f\t%.2f\t%.3f\t%ld\t%d\n", name.c_str(), summary.finished ? 1 : 0,
+           summary.ticks, summary.steps, summary.turns, summary.revisits, summary.optimalLength,
+           summary.motionTimeS, summary.speedRunCost, summary.optimalSpeedRunCost,
+           summary.sensedFraction, summary.redundantSensors, cached ? 1 : 0);
+}
+
+//without a recorder, for a cached run, only the runs row is written
+static void saveRun(const cliOptions &opts, const runSummary &summary, const runRecorder *recorder)
+{
+    if(opts.statsDir.empty())
+    {
+        return;
+    }
+    bool saved = appendRunCsv(statsPath(opts.statsDir, STATS_RUNS_CSV), summary) &&
+                 appendRunColumns(statsPath(opts.statsDir, STATS_RUNS_COL), summary);
+    if(!recorder)
+    {
+        if(!saved)
+        {
+            fprintf(stderr, "ERROR 206: could not write run statistics to %s\n", opts.statsDir.c_str());
+        }
+        return;
+    }
+    saved = saved &&
+            appendStepCsv(statsPath(opts.statsDir, STATS_STEPS_CSV), summary.runId, recorder->steps()) &&
+            appendStepColumns(statsPath(opts.statsDir, STATS_STEPS_COL), summary.runId, recorder->steps());
+    if(recorder->steps().lost())
+    {
+        fprintf(stderr, "ERROR 206: %lld of %lld steps could not be kept in the temporary step log, %s is missing them\n",
+                recorder->steps().lost(), recorder->steps().size(), STATS_STEPS_CSV);
+    }
+    else if(!saved)
+    {
+        fprintf(stderr, "ERROR 206: could not write run statistics to %s\n", opts.statsDir.c_str());
+    }
+}
+
+//one row per run named maze#run, then a comment line with the session score
+static bool runCompetition(const cliOptions &opts, std::shared_ptr<const mazeLayout> layout, mouseAI &ai,
+                           runRecorder &recorder, const std::string &maze, aiListener *listener)
+{
+    competitionSession session(opts.rules);
+    while(!session.isOver())
+    {
+        int run = session.nextRun();
+        ai.runStarted(run);
+        runSummary summary = runMaze(layout, ai, session.nextOptions(), recorder, maze, opts.ai, listener);
+        session.addRun(summary);
+        printRun(maze + "#" + std::to_string(run), summary, false);
+        saveRun(opts, summary, &recorder);
+    }
+
+    const sessionResult &result = session.result();
+    if(result.bestRun < 0)
+    {
+        printf("# %s: no run reached the goal, %.3f s used\n", maze.c_str(), result.usedTimeS);
+        return false;
+    }
+    printf("# %s: best run #%d %.3f s, score %.3f s, %.3f of %.0f s used\n", maze.c_str(), result.bestRun,
+           result.bestTimeS, result.score, result.usedTimeS, opts.rules.totalTimeS);
+    return true;
+}
+
+//one row per cell, a picture of the successes unless -q, then a comment line with the totals
+static bool runSweep(const cliOptions &opts, std::shared_ptr<const mazeLayout> layout, const std::string &maze)
+{
+    std::string name = opts.ai;
+    sweepMap map = sweepStarts(layout, [name]() { return createAI(name); }, opts.run.maxTicks, opts.threads);
+    for(int y = map.height()-1; y >= 0; y--)
+    {
+        for(int x = 0; x < map.width(); x++)
+        {
+            printf("%s\t%d\t%d\t%d\t%.1f\n", maze.c_str(), x+1, y+1, map.successes(x, y), map.meanSteps(x, y));
+        }
+    }
+    if(!opts.quiet)
+    {
+        for(int y = map.height()-1; y >= 0; y--)
+        {
+            std::string row = "# ";
+            for(int x = 0; x < map.width(); x++)
+            {
+                row += (char)('0' + map.successes(x, y));
+            }
+            printf("%s\n", row.c_str());
+        }
+    }
+    printf("# %s: %d of %d start poses reach the goal, %d loop, %d time out, %d finish outside the goal\n",
+           maze.c_str(), map.count(oGOAL), map.runs(), map.count(oLOOP), map.count(oTIMEOUT), map.count(oFALSE_FINISH));
+    return map.count(oGOAL) == map.runs();
+}
+
+int main(int argc, char *argv[])
+{
+    cliOptions opts;
+    if(!parseArgs(argc, argv, opts))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    motionScorer scorer(opts.motion);
+    runRecorder recorder;
+    recorder.setScorer(&scorer);
+    recorder.setPlanner(&opts.costs);
+    spectatorStream stream;
+    if(!opts.spectate.empty())
+    {
+        std::string error;
+        if(!stream.listen(opts.spectate, error))
+        {
+            fprintf(stderr, "%s\n", error.c_str());
+            return 2;
+        }
+        //runs take milliseconds, without this nobody would see them
+        fprintf(stderr, "waiting for a viewer on %s\n", opts.spectate.c_str());
+        while(!stream.viewers())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+    cliListener listener(opts.quiet, stream.isListening() ? &stream : NULL);
+
+    resultCache cache;
+    cacheKey key;
+    if(!opts.cacheFile.empty())
+    {
+        if(!cache.open(opts.cacheFile))
+        {
+            fprintf(stderr, "ERROR 207: could not open result cache %s\n", opts.cacheFile.c_str());
+            return 2;
+        }
+        //without the binary a rebuilt AI would be served its old results
+        if(!aiHash(selfPath(argv[0]), opts.ai, key.aiHash))
+        {
+            fprintf(stderr, "ERROR 207: could not read %s to key the result cache, run without --cache\n", selfPath(argv[0]).c_str());
+            return 2;
+        }
+        key.configHash = configHash(opts.motion, opts.costs, opts.run.maxTicks, opts.run.stopAtGoal);
+        key.startX = opts.run.startX;
+        key.startY = opts.run.startY;
+        key.startDir = opts.run.startDir;
+    }
+
+    if(opts.sweep)
+    {
+        printf("maze\tx\ty\treached\tmean_steps\n");
+    }
+    else
+    {
+        printf("maze\tfinished\tticks\tsteps\tturns\trevisits\toptimal\tmotion_s\tspeed_run\toptimal_speed_run\tsensed\tredundant\tcached\n");
+    }
+    int failures = 0;
+    for(size_t i = 0; i < opts.mazes.size(); i++)
+    {
+        std::string error;
+        std::shared_ptr<mazeLayout> layout = loadMazeFile(opts.mazes[i], error);
+        if(!layout)
+        {
+            fprintf(stderr, "%s\n", error.c_str());
+            failures++;
+            continue;
+        }
+
+        stream.setMaze(*layout);
+
+        //a fresh AI per maze so nothing carries over between runs
+        std::unique_ptr<mouseAI> ai(createAI(opts.ai));
+        if(!ai)
+        {
+            fprintf(stderr, "unknown AI \"%s\"\n", opts.ai.c_str());
+            usage(argv[0]);
+            return 2;
+        }
+
+        if(opts.sweep)
+        {
+            if(!runSweep(opts, layout, opts.mazes[i]))
+            {
+                failures++;
+            }
+            continue;
+        }
+        if(opts.session)
+        {
+            if(!runCompetition(opts, layout, *ai, recorder, opts.mazes[i], &listener))
+            {
+                failures++;
+            }
+            continue;
+        }
+
+        runSummary summary;
+        key.mazeHash = layout->hash();
+        bool cached = !opts.cacheFile.empty() && cache.find(key, summary);
+        if(cached)
+        {
+            summary.runId = newRunId();
+            summary.maze = opts.mazes[i];
+            summary.ai = opts.ai;
+        }
+        else
+        {
+            summary = runMaze(layout, *ai, opts.run, recorder, opts.mazes[i], opts.ai, &listener);
+            if(!opts.cacheFile.empty())
+            {
+                cache.store(key, summary);
+            }
+        }
+        printRun(opts.mazes[i], summary, cached);
+        if(!summary.finished)
+        {
+            failures++;
+        }
+
+        //cached results have no step log to export
+        saveRun(opts, summary, cached ? NULL : &recorder);
+    }
+    return failures ? 1 : 0;
+}
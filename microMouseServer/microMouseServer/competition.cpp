@@ -0,0 +1,53 @@
+#include "competition.h"
+
+sessionRules::sessionRules() :
+    maxRuns(5),
+    totalTimeS(600),
+    searchPenalty(1.0/30),
+    maxTicksPerRun(100000)
+{
+}
+
+sessionResult::sessionResult() :
+    bestRun(-1),
+    bestTimeS(-1),
+    usedTimeS(0),
+    score(-1)
+{
+}
+
+competitionSession::competitionSession(const sessionRules &rules) :
+    _rules(rules)
+{
+}
+
+bool competitionSession::isOver() const
+{
+    return nextRun() >= _rules.maxRuns || remainingS() <= 0;
+}
+
+runOptions competitionSession::nextOptions() const
+{
+    runOptions options;
+    options.maxTicks = _rules.maxTicksPerRun;
+    options.stopAtGoal = true;
+    options.timeLimitS = remainingS();
+    return options;
+}
+
+void competitionSession::addRun(const runSummary &summary)
+{
+    double before = _result.usedTimeS;
+    double runTime = summary.motionTimeS > 0 ? summary.motionTimeS : 0;
+    _result.runs.push_back(summary);
+    _result.usedTimeS += runTime;
+
+    //a run that hit the budget is cut off and can not count
+    if(summary.finished && _result.usedTimeS <= _rules.totalTimeS &&
+       (_result.bestRun < 0 || runTime < _result.bestTimeS))
+    {
+        _result.bestRun = nextRun() - 1;
+        _result.bestTimeS = runTime;
+        _result.score = runTime + _rules.searchPenalty * before;
+    }
+}
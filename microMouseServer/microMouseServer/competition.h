@@ -0,0 +1,56 @@
+#ifndef COMPETITION_H
+#define COMPETITION_H
+
+#include "batchRun.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+//official style session: a search run and then speed runs, all from the maze's start
+struct sessionRules
+{
+    int maxRuns;            //the search run counts as the first
+    double totalTimeS;      //kinematic seconds for all runs together
+    double searchPenalty;   //share of the time spent before the best run added to its score
+    long maxTicksPerRun;
+
+    sessionRules();
+};
+
+struct sessionResult
+{
+    std::vector<runSummary> runs;
+    int bestRun;            //index into runs, -1 if no run reached the goal
+    double bestTimeS;
+    double usedTimeS;
+    double score;           //best run plus the search penalty, -1 without a finished run
+
+    sessionResult();
+};
+
+/*
+ * Keeps track of a session one run at a time so the caller can look at each
+ * run as it ends. Use the same AI object for every run so it keeps what it
+ * learnt, and call its runStarted() before each one. Runs stop as soon as
+ * the mouse enters the goal and are cut short when the time budget runs
+ * out. The recorder must have a scorer, without one there is no clock and
+ * only maxRuns ends the session.
+ */
+class competitionSession
+{
+public:
+    explicit competitionSession(const sessionRules &rules = sessionRules());
+
+    bool isOver() const;
+    int nextRun() const { return (int)_result.runs.size(); }
+    double remainingS() const { return _rules.totalTimeS - _result.usedTimeS; }
+    runOptions nextOptions() const;
+    void addRun(const runSummary &summary);
+    const sessionResult &result() const { return _result; }
+
+private:
+    sessionRules _rules;
+    sessionResult _result;
+};
+
+#endif // COMPETITION_H
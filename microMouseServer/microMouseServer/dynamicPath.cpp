@@ -0,0 +1,149 @@
+#include "dynamicPath.h"
+#include <functional>
+
+dynamicPath::dynamicPath() :
+    _width(0),
+    _height(0),
+    _expanded(0)
+{
+}
+
+bool dynamicPath::canStep(const mazeLayout &layout, int x, int y, mDirection dir) const
+{
+    //moves are checked on the cell being left, the same way simState does
+    return layout.contains(x + stepX(dir), y + stepY(dir)) && !layout.isWall(x, y, dir);
+}
+
+void dynamicPath::reset(const mazeLayout &layout)
+{
+    _width = layout.width();
+    _height = layout.height();
+    _g.assign(_width*_height, DIST_UNREACHABLE);
+    _rhs.assign(_width*_height, DIST_UNREACHABLE);
+    _open = std::priority_queue<entry, std::vector<entry>, std::greater<entry> >();
+    for(int cell = 0; cell < _width*_height; cell++)
+    {
+        if(layout.isGoal(cell % _width, cell / _width))
+        {
+            _rhs[cell] = 0;
+            _open.push(entry(0, cell));
+        }
+    }
+    repair(layout);
+}
+
+void dynamicPath::updateCell(const mazeLayout &layout, int cell)
+{
+    int x = cell % _width, y = cell / _width;
+    if(!layout.isGoal(x, y))
+    {
+        int best = DIST_UNREACHABLE;
+        for(int d = 0; d < 4; d++)
+        {
+            mDirection dir = (mDirection)d;
+            if(canStep(layout, x, y, dir))
+            {
+                int next = _g[(y + stepY(dir))*_width + x + stepX(dir)];
+                if(next + 1 < best)
+                {
+                    best = next + 1;
+                }
+            }
+        }
+        _rhs[cell] = best;
+    }
+    if(_g[cell] != _rhs[cell])
+    {
+        _open.push(entry(_g[cell] < _rhs[cell] ? _g[cell] : _rhs[cell], cell));
+    }
+}
+
+void dynamicPath::cellChanged(const mazeLayout &layout, int x, int y)
+{
+    if(layout.width() != _width || layout.height() != _height)
+    {
+        reset(layout);
+        return;
+    }
+    updateCell(layout, y*_width + x);
+}
+
+void dynamicPath::repair(const mazeLayout &layout)
+{
+    _expanded = 0;
+    while(!_open.empty())
+    {
+        entry top = _open.top();
+        _open.pop();
+        int cell = top.second;
+        int key = _g[cell] < _rhs[cell] ? _g[cell] : _rhs[cell];
+        //stale queue entries are skipped instead of removed
+        if(_g[cell] == _rhs[cell] || top.first != key)
+        {
+            continue;
+        }
+        _expanded++;
+
+        if(_g[cell] > _rhs[cell])
+        {
+            _g[cell] = _rhs[cell];
+        }
+        else
+        {
+            _g[cell] = DIST_UNREACHABLE;
+            updateCell(layout, cell);
+        }
+
+        //every neighbour that can step into this cell depends on it
+        int x = cell % _width, y = cell / _width;
+        for(int d = 0; d < 4; d++)
+        {
+            mDirection dir = (mDirection)d;
+            int px = x + stepX(dir), py = y + stepY(dir);
+            if(layout.contains(px, py) && canStep(layout, px, py, behind(dir)))
+            {
+                updateCell(layout, py*_width + px);
+            }
+        }
+    }
+}
+
+std::vector<pathStep> dynamicPath::pathFrom(const mazeLayout &layout, int startX, int startY) const
+{
+    std::vector<pathStep> path;
+    int x = startX - 1, y = startY - 1;
+    if(!layout.contains(x, y) || _width != layout.width() || _g[y*_width + x] >= DIST_UNREACHABLE)
+    {
+        return path;
+    }
+    while(true)
+    {
+        pathStep step;
+        step.x = x + 1;
+        step.y = y + 1;
+        step.heading = 0;
+        path.push_back(step);
+        if(_g[y*_width + x] == 0)
+        {
+            break;
+        }
+        bool moved = false;
+        for(int d = 0; d < 4 && !moved; d++)
+        {
+            mDirection dir = (mDirection)d;
+            if(canStep(layout, x, y, dir) && _g[(y + stepY(dir))*_width + x + stepX(dir)] == _g[y*_width + x] - 1)
+            {
+                path.back().heading = dir*2;
+                x += stepX(dir);
+                y += stepY(dir);
+                moved = true;
+            }
+        }
+        if(!moved)
+        {
+            //only possible if repair() has not been run since the last change
+            break;
+        }
+    }
+    return path;
+}
@@ -0,0 +1,48 @@
+#ifndef DYNAMICPATH_H
+#define DYNAMICPATH_H
+
+#include "mazeState.h"
+#include "pathPlanner.h"
+#include <queue>
+#include <vector>
+
+#define DIST_UNREACHABLE 0x3FFFFFFF
+
+/*
+ * Distance from every cell to the goal, repaired incrementally when walls
+ * change (Lifelong Planning A* run backwards from the goal with no
+ * heuristic, so the whole field stays consistent). After an edit only the
+ * cells whose distance actually changes are expanded.
+ */
+class dynamicPath
+{
+public:
+    dynamicPath();
+
+    void reset(const mazeLayout &layout);
+    void cellChanged(const mazeLayout &layout, int x, int y);
+    void repair(const mazeLayout &layout);
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+    int distance(int x, int y) const { return _g[y*_width + x]; }
+    const std::vector<int> &distances() const { return _g; }
+    int expanded() const { return _expanded; }
+
+    //walks downhill from a 1 based cell to the goal
+    std::vector<pathStep> pathFrom(const mazeLayout &layout, int startX, int startY) const;
+
+private:
+    typedef std::pair<int, int> entry;
+
+    void updateCell(const mazeLayout &layout, int cell);
+    bool canStep(const mazeLayout &layout, int x, int y, mDirection dir) const;
+
+    int _width, _height;
+    int _expanded;
+    std::vector<int> _g;
+    std::vector<int> _rhs;
+    std::priority_queue<entry, std::vector<entry>, std::greater<entry> > _open;
+};
+
+#endif // DYNAMICPATH_H
@@ -0,0 +1,237 @@
+/*
+ * Maze lint, no Qt. Checks any number of .maz files and directories of them
+ * for walls only one cell has, gaps in the outside wall, repeated or missing
+ * cells and goals the start can not reach. --fix writes the repaired mazes
+ * back over the files.
+ */
+#include "mazeLint.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+struct lintOptions
+{
+    bool fix;
+    bool quiet;
+    int threads;
+    std::vector<std::string> paths;
+
+    lintOptions() : fix(false), quiet(false), threads(0) {}
+};
+
+//what one file came to, filled in by a worker and printed in file order
+struct lintResult
+{
+    std::string out;
+    bool unreadable;
+    bool clean;
+    bool repaired;
+    bool failed;        //still has problems after any repair
+    bool done;
+
+    lintResult() : unreadable(false), clean(false), repaired(false), failed(false), done(false) {}
+};
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options] path [path ...]\n"
+            "  path              a .maz file, or a directory searched for them\n"
+            "  --fix             write repaired mazes back over the files, walls either\n"
+            "                    cell has go on both and the outside is closed\n"
+            "  --threads N       files checked at once (default one per core)\n"
+            "  -q                only print the totals\n", name);
+}
+
+static bool parseArgs(int argc, char *argv[], lintOptions &opts)
+{
+    for(int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if(arg == "-q")
+        {
+            opts.quiet = true;
+        }
+        else if(arg == "--fix")
+        {
+            opts.fix = true;
+        }
+        else if(arg == "--threads" && hasValue)
+        {
+            opts.threads = atoi(argv[++i]);
+        }
+        else if(arg[0] == '-')
+        {
+            return false;
+        }
+        else
+        {
+            opts.paths.push_back(arg);
+        }
+    }
+    return !opts.paths.empty();
+}
+
+//directories are searched all the way down, sorted so the output is the same every time
+static bool collectMazes(const std::vector<std::string> &paths, std::vector<std::string> &mazes)
+{
+    for(size_t i = 0; i < paths.size(); i++)
+    {
+        std::error_code err;
+        if(!fs::is_directory(paths[i], err))
+        {
+            mazes.push_back(paths[i]);
+            continue;
+        }
+        std::vector<std::string> found;
+        for(fs::recursive_directory_iterator it(paths[i], err), end; !err && it != end; it.increment(err))
+        {
+            if(it->path().extension() == ".maz" && it->is_regular_file(err))
+            {
+                found.push_back(it->path().string());
+            }
+        }
+        if(err)
+        {
+            fprintf(stderr, "%s: ERROR 202: %s\n", paths[i].c_str(), err.message().c_str());
+            return false;
+        }
+        std::sort(found.begin(), found.end());
+        mazes.insert(mazes.end(), found.begin(), found.end());
+    }
+    return true;
+}
+
+static void report(std::ostringstream &out, const std::string &path, const lintReport &lint)
+{
+    for(size_t i = 0; i < lint.issues.size(); i++)
+    {
+        out << path << ":";
+        if(lint.issues[i].line)
+        {
+            out << lint.issues[i].line << ":";
+        }
+        out << " ERROR 212: " << lint.issues[i].text << "\n";
+    }
+    if(lint.total() > (int)lint.issues.size())
+    {
+        out << path << ": " << lint.total() - (int)lint.issues.size() << " more problems not shown\n";
+    }
+}
+
+static void lintFile(const std::string &path, bool fix, lintResult &result)
+{
+    std::ostringstream out;
+    mazeFileContents contents;
+    std::string error;
+    if(!readMazeFile(path, contents, error))
+    {
+        out << error << "\n";
+        result.unreadable = true;
+        result.failed = true;
+        result.out = out.str();
+        return;
+    }
+
+    lintReport lint = lintMaze(contents);
+    result.clean = lint.clean();
+    report(out, path, lint);
+    //an unreachable goal needs a wall taken out by hand, everything else can be put right
+    bool fixable = lint.total() > (lint.goalReachable ? 0 : 1);
+    if(fix && fixable)
+    {
+        std::shared_ptr<mazeLayout> fixed = repairMaze(*contents.layout);
+        std::string tmp = path + ".lint";
+        if(saveMazeFile(tmp, *fixed, error) && !std::rename(tmp.c_str(), path.c_str()))
+        {
+            result.repaired = true;
+            out << path << ": repaired\n";
+        }
+        else
+        {
+            std::remove(tmp.c_str());
+            out << path << ": ERROR 202: could not write the repaired maze\n";
+        }
+    }
+    result.failed = !lint.clean() && !(result.repaired && lint.repairable());
+    result.out = out.str();
+}
+
+int main(int argc, char *argv[])
+{
+    lintOptions opts;
+    std::vector<std::string> mazes;
+    if(!parseArgs(argc, argv, opts))
+    {
+        usage(argv[0]);
+        return 2;
+    }
+    if(!collectMazes(opts.paths, mazes))
+    {
+        return 2;
+    }
+
+    int threads = opts.threads > 0 ? opts.threads : (int)std::thread::hardware_concurrency();
+    threads = std::max(1, std::min(threads, (int)mazes.size()));
+
+    //files are handed out one at a time, results are printed in order as soon as they are ready
+    std::vector<lintResult> results(mazes.size());
+    std::atomic<size_t> next(0);
+    std::mutex lock;
+    std::condition_variable ready;
+    auto worker = [&]()
+    {
+        for(size_t i = next++; i < mazes.size(); i = next++)
+        {
+            lintResult result;
+            lintFile(mazes[i], opts.fix, result);
+            result.done = true;
+            std::lock_guard<std::mutex> hold(lock);
+            results[i] = result;
+            ready.notify_all();
+        }
+    };
+    std::vector<std::thread> pool;
+    for(int i = 0; i < threads; i++)
+    {
+        pool.push_back(std::thread(worker));
+    }
+
+    int clean = 0, repaired = 0, failed = 0, unreadable = 0;
+    for(size_t i = 0; i < mazes.size(); i++)
+    {
+        std::string out;
+        {
+            std::unique_lock<std::mutex> hold(lock);
+            ready.wait(hold, [&]() { return results[i].done; });
+            out.swap(results[i].out);
+        }
+        if(!opts.quiet)
+        {
+            fputs(out.c_str(), stdout);
+        }
+        clean += results[i].clean;
+        repaired += results[i].repaired;
+        failed += results[i].failed;
+        unreadable += results[i].unreadable;
+    }
+    for(size_t i = 0; i < pool.size(); i++)
+    {
+        pool[i].join();
+    }
+
+    printf("# %d mazes, %d clean, %d with problems, %d repaired, %d unreadable\n",
+           (int)mazes.size(), clean, (int)mazes.size() - clean - unreadable, repaired, unreadable);
+    return failed || unreadable ? 1 : 0;
+}
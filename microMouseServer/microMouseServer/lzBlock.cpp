@@ -0,0 +1,146 @@
+#include "lzBlock.h"
+#include <cstring>
+
+#define LZ_MIN_MATCH 4
+#define LZ_MAX_OFFSET 65535
+#define LZ_HASH_BITS 12
+
+static unsigned int read32(const unsigned char *at)
+{
+    unsigned int val;
+    memcpy(&val, at, sizeof(val));
+    return val;
+}
+
+static unsigned int hash32(unsigned int seq)
+{
+    return (seq * 2654435761U) >> (32 - LZ_HASH_BITS);
+}
+
+//the part of a length that does not fit in its nibble, 255 at a time
+static void putLength(std::vector<unsigned char> &out, size_t len)
+{
+    for(; len >= 255; len -= 255)
+    {
+        out.push_back(255);
+    }
+    out.push_back((unsigned char)len);
+}
+
+static bool getLength(const unsigned char *&ip, const unsigned char *end, size_t &len)
+{
+    unsigned char more;
+    do
+    {
+        if(ip == end)
+        {
+            return false;
+        }
+        more = *ip++;
+        len += more;
+    } while(more == 255);
+    return true;
+}
+
+static void putSequence(std::vector<unsigned char> &out, const unsigned char *literals, size_t litLen, size_t offset, size_t matchLen)
+{
+    size_t matchCode = matchLen ? matchLen - LZ_MIN_MATCH : 0;
+    out.push_back((unsigned char)(((litLen < 15 ? litLen : 15) << 4) | (matchCode < 15 ? matchCode : 15)));
+    if(litLen >= 15)
+    {
+        putLength(out, litLen - 15);
+    }
+    out.insert(out.end(), literals, literals + litLen);
+    if(!matchLen)
+    {
+        return;
+    }
+    out.push_back((unsigned char)(offset & 0xFF));
+    out.push_back((unsigned char)(offset >> 8));
+    if(matchCode >= 15)
+    {
+        putLength(out, matchCode - 15);
+    }
+}
+
+void lzCompress(const unsigned char *in, size_t len, std::vector<unsigned char> &out)
+{
+    out.clear();
+    out.reserve(len + len / 255 + 16);
+
+    //last position each 4 byte sequence was seen at, one guess per hash is enough for run logs
+    std::vector<long> table(1 << LZ_HASH_BITS, -1);
+    size_t anchor = 0, pos = 0;
+    while(pos + LZ_MIN_MATCH <= len)
+    {
+        unsigned int seq = read32(in + pos);
+        long &slot = table[hash32(seq)];
+        long cand = slot;
+        slot = (long)pos;
+        if(cand < 0 || pos - cand > LZ_MAX_OFFSET || read32(in + cand) != seq)
+        {
+            pos++;
+            continue;
+        }
+        size_t matchLen = LZ_MIN_MATCH;
+        while(pos + matchLen < len && in[cand + matchLen] == in[pos + matchLen])
+        {
+            matchLen++;
+        }
+        putSequence(out, in + anchor, pos - anchor, pos - cand, matchLen);
+        pos += matchLen;
+        anchor = pos;
+    }
+    putSequence(out, in + anchor, len - anchor, 0, 0);
+}
+
+bool lzDecompress(const unsigned char *in, size_t len, unsigned char *out, size_t outLen)
+{
+    const unsigned char *ip = in, *end = in + len;
+    unsigned char *op = out, *outEnd = out + outLen;
+    while(ip < end)
+    {
+        unsigned int token = *ip++;
+        size_t litLen = token >> 4;
+        if(litLen == 15 && !getLength(ip, end, litLen))
+        {
+            return false;
+        }
+        if(litLen > (size_t)(end - ip) || litLen > (size_t)(outEnd - op))
+        {
+            return false;
+        }
+        memcpy(op, ip, litLen);
+        op += litLen;
+        ip += litLen;
+        if(ip == end)
+        {
+            break;
+        }
+
+        if(end - ip < 2)
+        {
+            return false;
+        }
+        size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        size_t matchLen = token & 15;
+        if(matchLen == 15 && !getLength(ip, end, matchLen))
+        {
+            return false;
+        }
+        matchLen += LZ_MIN_MATCH;
+        if(offset == 0 || offset > (size_t)(op - out) || matchLen > (size_t)(outEnd - op))
+        {
+            return false;
+        }
+        //a match may overlap what it is writing, so copy a byte at a time
+        const unsigned char *from = op - offset;
+        for(size_t i = 0; i < matchLen; i++)
+        {
+            op[i] = from[i];
+        }
+        op += matchLen;
+    }
+    return op == outEnd;
+}
@@ -0,0 +1,22 @@
+#ifndef LZBLOCK_H
+#define LZBLOCK_H
+
+#include <cstddef>
+#include <vector>
+
+/*
+ * Small LZ77 block compressor in the LZ4 layout, fast enough to run on
+ * every chunk of a long run without being noticed. A block is a list of
+ * sequences:
+ *   token          high nibble literal count, low nibble match length - 4,
+ *                  15 in either means more length bytes follow (255 = keep going)
+ *   literals
+ *   u16 offset     little endian distance back to the match, 1 to 65535
+ * The last sequence is literals only. Blocks do not refer to each other.
+ */
+void lzCompress(const unsigned char *in, size_t len, std::vector<unsigned char> &out);
+
+//false if the block is damaged or does not come out at exactly outLen bytes
+bool lzDecompress(const unsigned char *in, size_t len, unsigned char *out, size_t outLen);
+
+#endif // LZBLOCK_H
@@ -4,7 +4,16 @@
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
-    microMouseServer w;
+
+    //--spectate PATH streams on another socket, so two windows can run in the same folder
+    QString spectate = SPECTATOR_PATH;
+    QStringList args = a.arguments();
+    int at = args.indexOf("--spectate");
+    if(at >= 0 && at + 1 < args.size())
+    {
+        spectate = args[at + 1];
+    }
+    microMouseServer w(0, spectate);
     w.show();
 
     return a.exec();
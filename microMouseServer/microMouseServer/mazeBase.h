@@ -2,7 +2,7 @@
 #define MAZE_BASE_H
 
 #include"mazeConst.h"
-#include<QGraphicsLineItem>
+#include<cstddef>
 enum Wall {TOP,BOTTOM,LEFT,RIGHT};
 
 class baseMapNode
@@ -0,0 +1,798 @@
+#include "mazeFile.h"
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <sstream>
+#include <vector>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+ * Read only view of a whole file. Mapped so a large maze is never copied
+ * into memory, the pages are read in as the parser walks over them.
+ */
+class mappedFile
+{
+public:
+    explicit mappedFile(const std::string &path);
+    ~mappedFile();
+
+    bool isOpen() const { return _open; }
+    const char *begin() const { return _data; }
+    const char *end() const { return _data + _size; }
+
+private:
+    mappedFile(const mappedFile &);
+    mappedFile &operator=(const mappedFile &);
+
+    bool _open;
+    const char *_data;
+    size_t _size;
+#ifdef _WIN32
+    HANDLE _file, _mapping;
+#endif
+};
+
+#ifdef _WIN32
+mappedFile::mappedFile(const std::string &path) :
+    _open(false),
+    _data(""),
+    _size(0),
+    _mapping(NULL)
+{
+    _file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+    LARGE_INTEGER size;
+    if(_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(_file, &size))
+    {
+        return;
+    }
+    _open = true;
+    //an empty file can not be mapped, it just has no cells
+    if(size.QuadPart == 0)
+    {
+        return;
+    }
+    _mapping = CreateFileMappingA(_file, NULL, PAGE_READONLY, 0, 0, NULL);
+    const char *view = _mapping ? (const char *)MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+    if(!view)
+    {
+        _open = false;
+        return;
+    }
+    _data = view;
+    _size = (size_t)size.QuadPart;
+}
+
+mappedFile::~mappedFile()
+{
+    if(_size)
+    {
+        UnmapViewOfFile(_data);
+    }
+    if(_mapping)
+    {
+        CloseHandle(_mapping);
+    }
+    if(_file != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(_file);
+    }
+}
+#else
+mappedFile::mappedFile(const std::string &path) :
+    _open(false),
+    _data(""),
+    _size(0)
+{
+    int fd = open(path.c_str(), O_RDONLY);
+    struct stat info;
+    if(fd < 0 || fstat(fd, &info) != 0 || !S_ISREG(info.st_mode))
+    {
+        if(fd >= 0)
+        {
+            close(fd);
+        }
+        return;
+    }
+    _open = true;
+    if(info.st_size > 0)
+    {
+        void *view = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if(view == MAP_FAILED)
+        {
+            _open = false;
+        }
+        else
+        {
+            madvise(view, info.st_size, MADV_SEQUENTIAL);
+            _data = (const char *)view;
+            _size = info.st_size;
+        }
+    }
+    //the mapping stays valid after the descriptor is closed
+    close(fd);
+}
+
+mappedFile::~mappedFile()
+{
+    if(_size)
+    {
+        munmap((void *)_data, _size);
+    }
+}
+#endif
+
+//a cell the file gives again, 0 based
+struct repeatedCell
+{
+    int x, y;
+    int line;
+};
+
+struct goalRect
+{
+    int x0, y0, x1, y1;
+    int line, col;
+};
+
+static const char dirNames[] = "RDLU";
+
+//start of the layout the parser grows, each side doubles when a cell lands outside it
+#define MAZE_FILE_FIRST_SIDE 16
+
+void cellLines::add(int x, int y, int line)
+{
+    if(_open && line == _run.line + _run.count)
+    {
+        //the second cell of a run decides which way it goes
+        if(_run.count == 1 && x == _run.x + 1 && y == _run.y)
+        {
+            _run.alongX = true;
+        }
+        int nextX = _run.alongX ? _run.x + _run.count : _run.x;
+        int nextY = _run.alongX ? _run.y : _run.y + _run.count;
+        if(x == nextX && y == nextY)
+        {
+            _run.count++;
+            return;
+        }
+    }
+    if(_open)
+    {
+        (_run.alongX ? _rows : _columns).push_back(_run);
+    }
+    _run.x = x;
+    _run.y = y;
+    _run.line = line;
+    _run.count = 1;
+    _run.alongX = false;
+    _open = true;
+}
+
+void cellLines::finish()
+{
+    if(_open)
+    {
+        (_run.alongX ? _rows : _columns).push_back(_run);
+        _open = false;
+    }
+    std::sort(_columns.begin(), _columns.end(), [](const lineRun &a, const lineRun &b)
+    {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+    std::sort(_rows.begin(), _rows.end(), [](const lineRun &a, const lineRun &b)
+    {
+        return a.y < b.y || (a.y == b.y && a.x < b.x);
+    });
+}
+
+//columns are sorted by x then y and rows by y then x, major is the first of the two
+int cellLines::find(const std::vector<lineRun> &runs, int major, int minor, bool alongX)
+{
+    //the last run that starts at or before the cell
+    size_t lo = 0, hi = runs.size();
+    while(lo < hi)
+    {
+        size_t mid = (lo + hi) / 2;
+        int runMajor = alongX ? runs[mid].y : runs[mid].x;
+        int runMinor = alongX ? runs[mid].x : runs[mid].y;
+        if(runMajor < major || (runMajor == major && runMinor <= minor))
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    if(!lo)
+    {
+        return 0;
+    }
+    const lineRun &run = runs[lo-1];
+    int runMajor = alongX ? run.y : run.x;
+    int runMinor = alongX ? run.x : run.y;
+    return runMajor == major && minor < runMinor + run.count ? run.line + minor - runMinor : 0;
+}
+
+int cellLines::lineOf(int x, int y) const
+{
+    int line = find(_columns, x, y, false);
+    return line ? line : find(_rows, y, x, true);
+}
+
+bool mazeFileContents::isGiven(int x, int y) const
+{
+    int cell = y*layout->width() + x;
+    return (given[cell >> 6] >> (cell & 63)) & 1;
+}
+
+/*
+ * Walks the buffer once, a line at a time, and keeps going after an error
+ * so one load reports every problem up to MAZE_FILE_MAX_ERRORS. Cells go
+ * straight into a layout that grows as larger ones turn up, with a bit per
+ * cell for the ones seen and their lines kept as cellLines runs.
+ */
+class mazeParser
+{
+public:
+    mazeParser(const std::string &path, const char *begin, const char *end);
+
+    bool parse();
+    bool build(mazeFileContents &contents, bool strict);
+    std::string errors() const { return _errors.str(); }
+
+private:
+    bool atLineEnd() const { return _pos == _end || *_pos == '\n'; }
+    int col(const char *at) const { return (int)(at - _lineStart) + 1; }
+    void skipSpace();
+    void skipLine();
+    void nextLine();
+    void error(int line, int col, const std::string &mesg);
+    void error(const char *at, const std::string &mesg) { error(_line, col(at), mesg); }
+    bool isGiven(int x, int y) const;
+    void resize(int width, int height);
+    bool readInt(int &val, int field, int fields, const char *name);
+    bool readFlag(unsigned char &walls, mDirection side, int field);
+    bool parseCell();
+    bool parseStart();
+    bool parseGoal();
+
+    std::string _path;
+    const char *_pos, *_end, *_lineStart;
+    int _line;
+    int _errorCount;
+    std::ostringstream _errors;
+
+    std::shared_ptr<mazeLayout> _layout;
+    std::vector<unsigned long long> _given;
+    cellLines _lines;
+    std::vector<repeatedCell> _repeats;
+    std::vector<goalRect> _goals;
+    int _largestX, _largestY;
+    bool _hasStart;
+    int _startX, _startY, _startLine, _startCol;
+    mDirection _startDir;
+};
+
+mazeParser::mazeParser(const std::string &path, const char *begin, const char *end) :
+    _path(path),
+    _pos(begin),
+    _end(end),
+    _lineStart(begin),
+    _line(1),
+    _errorCount(0),
+    _largestX(0),
+    _largestY(0),
+    _hasStart(false),
+    _startX(1),
+    _startY(1),
+    _startLine(0),
+    _startCol(0),
+    _startDir(dUP)
+{
+}
+
+void mazeParser::error(int line, int col, const std::string &mesg)
+{
+    _errorCount++;
+    if(_errorCount <= MAZE_FILE_MAX_ERRORS)
+    {
+        if(_errorCount > 1)
+        {
+            _errors << "\n";
+        }
+        //line 0 is a problem with the file as a whole
+        _errors << _path;
+        if(line)
+        {
+            _errors << ":" << line << ":" << col;
+        }
+        _errors << ": ERROR 201: " << mesg;
+    }
+    else if(_errorCount == MAZE_FILE_MAX_ERRORS + 1)
+    {
+        _errors << "\n" << _path << ": more errors not shown";
+    }
+}
+
+void mazeParser::skipSpace()
+{
+    while(_pos != _end && (*_pos == ' ' || *_pos == '\t' || *_pos == '\r'))
+    {
+        _pos++;
+    }
+}
+
+void mazeParser::skipLine()
+{
+    while(!atLineEnd())
+    {
+        _pos++;
+    }
+}
+
+void mazeParser::nextLine()
+{
+    _pos++;
+    _lineStart = _pos;
+    _line++;
+}
+
+bool mazeParser::readInt(int &val, int field, int fields, const char *name)
+{
+    skipSpace();
+    if(atLineEnd())
+    {
+        std::ostringstream mesg;
+        mesg << "line ends after " << field << " of " << fields << " fields, expected " << name;
+        error(_pos, mesg.str());
+        return false;
+    }
+    const char *start = _pos;
+    std::from_chars_result res = std::from_chars(_pos, _end, val);
+    if(res.ec == std::errc::result_out_of_range)
+    {
+        error(start, std::string(name) + " is out of range");
+        return false;
+    }
+    //"12x" is not a number either
+    if(res.ec != std::errc() || (res.ptr != _end && *res.ptr != ' ' && *res.ptr != '\t' && *res.ptr != '\r' && *res.ptr != '\n'))
+    {
+        error(start, std::string("expected a number for ") + name);
+        return false;
+    }
+    _pos = res.ptr;
+    return true;
+}
+
+bool mazeParser::readFlag(unsigned char &walls, mDirection side, int field)
+{
+    static const char *names[4] = {"the right wall", "the bottom wall", "the left wall", "the top wall"};
+    int val;
+    skipSpace();
+    const char *start = _pos;
+    if(!readInt(val, field, 6, names[side]))
+    {
+        return false;
+    }
+    if(val != 0 && val != 1)
+    {
+        error(start, std::string("expected 0 or 1 for ") + names[side]);
+        return false;
+    }
+    walls |= val << side;
+    return true;
+}
+
+bool mazeParser::isGiven(int x, int y) const
+{
+    int cell = y*_layout->width() + x;
+    return (_given[cell >> 6] >> (cell & 63)) & 1;
+}
+
+//copies the cells seen so far into a layout of the new size, nothing outside it is kept
+void mazeParser::resize(int width, int height)
+{
+    std::shared_ptr<mazeLayout> layout = std::make_shared<mazeLayout>(width, height);
+    std::vector<unsigned long long> given((width*height + 63) / 64, 0);
+    for(int y = 0; _layout && y < _layout->height() && y < height; y++)
+    {
+        for(int x = 0; x < _layout->width() && x < width; x++)
+        {
+            if(!isGiven(x, y))
+            {
+                continue;
+            }
+            given[(y*width + x) >> 6] |= 1ULL << ((y*width + x) & 63);
+            for(int d = 0; d < 4; d++)
+            {
+                if(_layout->isWall(x, y, (mDirection)d))
+                {
+                    layout->setWall(x, y, (mDirection)d, true);
+                }
+            }
+        }
+    }
+    _layout = layout;
+    _given.swap(given);
+}
+
+bool mazeParser::parseCell()
+{
+    int x, y;
+    unsigned char walls = 0;
+    const char *start = _pos;
+    if(!readInt(x, 0, 6, "x") || !readInt(y, 1, 6, "y") ||
+       !readFlag(walls, dUP, 2) || !readFlag(walls, dDOWN, 3) ||
+       !readFlag(walls, dLEFT, 4) || !readFlag(walls, dRIGHT, 5))
+    {
+        return false;
+    }
+    if(x < 1 || y < 1 || x > MAZE_FILE_MAX_SIDE || y > MAZE_FILE_MAX_SIDE)
+    {
+        std::ostringstream mesg;
+        mesg << "cell (" << x << ", " << y << ") is outside 1.." << MAZE_FILE_MAX_SIDE;
+        error(start, mesg.str());
+        return false;
+    }
+    _largestX = x > _largestX ? x : _largestX;
+    _largestY = y > _largestY ? y : _largestY;
+    x--;
+    y--;
+
+    int width = _layout ? _layout->width() : MAZE_FILE_FIRST_SIDE;
+    int height = _layout ? _layout->height() : MAZE_FILE_FIRST_SIDE;
+    if(!_layout || x >= width || y >= height)
+    {
+        while(x >= width)
+        {
+            width = std::min(width*2, MAZE_FILE_MAX_SIDE);
+        }
+        while(y >= height)
+        {
+            height = std::min(height*2, MAZE_FILE_MAX_SIDE);
+        }
+        resize(width, height);
+    }
+
+    //the first of any repeated cells wins
+    if(isGiven(x, y))
+    {
+        repeatedCell repeat;
+        repeat.x = x;
+        repeat.y = y;
+        repeat.line = _line;
+        _repeats.push_back(repeat);
+        return true;
+    }
+    _given[(y*width + x) >> 6] |= 1ULL << ((y*width + x) & 63);
+    for(int d = 0; d < 4; d++)
+    {
+        if((walls >> d) & 1)
+        {
+            _layout->setWall(x, y, (mDirection)d, true);
+        }
+    }
+    _lines.add(x, y, _line);
+    return true;
+}
+
+bool mazeParser::parseStart()
+{
+    _startLine = _line;
+    _startCol = col(_pos);
+    if(!readInt(_startX, 1, 4, "x") || !readInt(_startY, 2, 4, "y"))
+    {
+        return false;
+    }
+    skipSpace();
+    const char *start = _pos;
+    if(atLineEnd() || (_pos + 1 != _end && _pos[1] != ' ' && _pos[1] != '\t' && _pos[1] != '\r' && _pos[1] != '\n'))
+    {
+        error(start, "expected U, D, L or R for the direction");
+        return false;
+    }
+    for(int d = 0; d < 4; d++)
+    {
+        if(*_pos == dirNames[d])
+        {
+            _startDir = (mDirection)d;
+            _pos++;
+            _hasStart = true;
+            return true;
+        }
+    }
+    error(start, "expected U, D, L or R for the direction");
+    return false;
+}
+
+bool mazeParser::parseGoal()
+{
+    goalRect goal;
+    goal.line = _line;
+    goal.col = col(_pos);
+    if(!readInt(goal.x0, 1, 3, "x") || !readInt(goal.y0, 2, 3, "y"))
+    {
+        return false;
+    }
+    skipSpace();
+    if(atLineEnd())
+    {
+        //single cell form
+        goal.x1 = goal.x0;
+        goal.y1 = goal.y0;
+    }
+    else
+    {
+        const char *start = _pos;
+        if(!readInt(goal.x1, 3, 5, "x1") || !readInt(goal.y1, 4, 5, "y1"))
+        {
+            return false;
+        }
+        if(goal.x1 < goal.x0 || goal.y1 < goal.y0)
+        {
+            error(start, "goal rectangle corners are the wrong way round");
+            return false;
+        }
+    }
+    _goals.push_back(goal);
+    return true;
+}
+
+bool mazeParser::parse()
+{
+    while(_pos != _end)
+    {
+        skipSpace();
+        if(_pos == _end)
+        {
+            break;
+        }
+        if(*_pos == '\n')
+        {
+            nextLine();
+            continue;
+        }
+
+        bool ok;
+        if((*_pos >= 'a' && *_pos <= 'z') || (*_pos >= 'A' && *_pos <= 'Z'))
+        {
+            const char *word = _pos;
+            while(!atLineEnd() && *_pos != ' ' && *_pos != '\t' && *_pos != '\r')
+            {
+                _pos++;
+            }
+            std::string name(word, _pos);
+            if(name == "start")
+            {
+                ok = parseStart();
+            }
+            else if(name == "goal")
+            {
+                ok = parseGoal();
+            }
+            else
+            {
+                error(word, "unknown rule \"" + name + "\"");
+                ok = false;
+            }
+        }
+        else
+        {
+            ok = parseCell();
+        }
+
+        if(ok)
+        {
+            skipSpace();
+            if(!atLineEnd())
+            {
+                error(_pos, "unexpected text at the end of the line");
+            }
+        }
+        skipLine();
+    }
+    if(!_layout && !_errorCount)
+    {
+        error(_line, 1, "no cells in the file");
+    }
+    return !_errorCount;
+}
+
+bool mazeParser::build(mazeFileContents &contents, bool strict)
+{
+    //a file with no cells at all has nothing to check
+    if(!_layout)
+    {
+        return false;
+    }
+    int width = _largestX, height = _largestY;
+    if(_layout->width() != width || _layout->height() != height)
+    {
+        resize(width, height);
+    }
+    std::shared_ptr<mazeLayout> layout = _layout;
+    _lines.finish();
+
+    for(size_t i = 0; i < _repeats.size(); i++)
+    {
+        const repeatedCell &c = _repeats[i];
+        contents.duplicates.push_back(std::make_pair(c.line, c.y*width + c.x));
+        if(strict)
+        {
+            std::ostringstream mesg;
+            mesg << "cell (" << c.x+1 << ", " << c.y+1 << ") was already given on line " << _lines.lineOf(c.x, c.y);
+            error(c.line, 1, mesg.str());
+        }
+    }
+
+    //a wall has two sides, both cells have to agree on it
+    for(int y = 0; y < height && strict; y++)
+    {
+        for(int x = 0; x < width; x++)
+        {
+            if(!isGiven(x, y))
+            {
+                continue;
+            }
+            if(x+1 < width && isGiven(x+1, y) && layout->isWall(x, y, dRIGHT) != layout->isWall(x+1, y, dLEFT))
+            {
+                std::ostringstream mesg;
+                mesg << "right wall of (" << x+1 << ", " << y+1 << ") does not match the left wall of ("
+                     << x+2 << ", " << y+1 << ") on line " << _lines.lineOf(x+1, y);
+                error(_lines.lineOf(x, y), 1, mesg.str());
+            }
+            if(y+1 < height && isGiven(x, y+1) && layout->isWall(x, y, dUP) != layout->isWall(x, y+1, dDOWN))
+            {
+                std::ostringstream mesg;
+                mesg << "top wall of (" << x+1 << ", " << y+1 << ") does not match the bottom wall of ("
+                     << x+1 << ", " << y+2 << ") on line " << _lines.lineOf(x, y+1);
+                error(_lines.lineOf(x, y), 1, mesg.str());
+            }
+        }
+    }
+
+    //the maze is as big as its largest cell, every cell up to it has to be there
+    long missing = 0;
+    for(int y = 0; y < height && strict; y++)
+    {
+        for(int x = 0; x < width; x++)
+        {
+            if(!isGiven(x, y) && missing++ < MAZE_FILE_MAX_ERRORS)
+            {
+                std::ostringstream mesg;
+                mesg << "cell (" << x+1 << ", " << y+1 << ") is missing";
+                error(0, 0, mesg.str());
+            }
+        }
+    }
+    if(missing > MAZE_FILE_MAX_ERRORS)
+    {
+        std::ostringstream mesg;
+        mesg << missing - MAZE_FILE_MAX_ERRORS << " more cells are missing";
+        error(0, 0, mesg.str());
+    }
+
+    //rules have to fit in the maze the cells describe
+    if(_hasStart)
+    {
+        if(!layout->contains(_startX-1, _startY-1))
+        {
+            error(_startLine, _startCol, "start is outside the maze");
+        }
+        layout->setStart(_startX, _startY, _startDir);
+    }
+    if(!_goals.empty())
+    {
+        layout->clearGoal();
+        for(size_t i = 0; i < _goals.size(); i++)
+        {
+            const goalRect &g = _goals[i];
+            if(!layout->contains(g.x0-1, g.y0-1) || !layout->contains(g.x1-1, g.y1-1))
+            {
+                error(g.line, g.col, "goal is outside the maze");
+                continue;
+            }
+            for(int x = g.x0; x <= g.x1; x++)
+            {
+                for(int y = g.y0; y <= g.y1; y++)
+                {
+                    layout->setGoalCell(x-1, y-1, true);
+                }
+            }
+        }
+    }
+    contents.layout = _errorCount ? std::shared_ptr<mazeLayout>() : layout;
+    contents.given.swap(_given);
+    contents.lines = std::move(_lines);
+    return !_errorCount;
+}
+
+static bool readMaze(const std::string &path, mazeFileContents &contents, std::string &error, bool strict)
+{
+    contents = mazeFileContents();
+    mappedFile file(path);
+    if(!file.isOpen())
+    {
+        error = path + ": ERROR 202: file not found";
+        return false;
+    }
+
+    //build even after syntax errors so the same pass reports repeated cells and walls that do not match
+    mazeParser parser(path, file.begin(), file.end());
+    bool parsed = parser.parse();
+    if(!parser.build(contents, strict) || !parsed)
+    {
+        error = parser.errors();
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<mazeLayout> loadMazeFile(const std::string &path, std::string &error)
+{
+    mazeFileContents contents;
+    readMaze(path, contents, error, true);
+    return contents.layout;
+}
+
+bool readMazeFile(const std::string &path, mazeFileContents &contents, std::string &error)
+{
+    return readMaze(path, contents, error, false);
+}
+
+bool saveMazeFile(const std::string &path, const mazeLayout &layout, std::string &error)
+{
+    FILE *file = fopen(path.c_str(), "w");
+    if(!file)
+    {
+        error = path + ": ERROR 202: could not write file";
+        return false;
+    }
+
+    //same order the editor has always written, a column at a time
+    std::string text = mazeRulesText(layout);
+    fputs(text.c_str(), file);
+    for(int x = 0; x < layout.width(); x++)
+    {
+        for(int y = 0; y < layout.height(); y++)
+        {
+            fprintf(file, "%d %d %d %d %d %d\n", x+1, y+1, layout.isWall(x, y, dUP), layout.isWall(x, y, dDOWN),
+                    layout.isWall(x, y, dLEFT), layout.isWall(x, y, dRIGHT));
+        }
+    }
+    if(fclose(file) != 0)
+    {
+        error = path + ": ERROR 202: could not write file";
+        return false;
+    }
+    return true;
+}
+
+std::string mazeRulesText(const mazeLayout &layout)
+{
+    if(layout.hasDefaultRules())
+    {
+        return std::string();
+    }
+    std::ostringstream text;
+    text << "start " << layout.startX() << " " << layout.startY() << " " << dirNames[layout.startDir()] << "\n";
+    for(int x = 0; x < layout.width(); x++)
+    {
+        for(int y = 0; y < layout.height(); y++)
+        {
+            if(layout.isGoal(x, y))
+            {
+                text << "goal " << x+1 << " " << y+1 << "\n";
+            }
+        }
+    }
+    return text.str();
+}
@@ -0,0 +1,80 @@
+#ifndef MAZEFILE_H
+#define MAZEFILE_H
+
+#include "mazeState.h"
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#define MAZE_FILE_MAX_ERRORS 20
+#define MAZE_FILE_MAX_SIDE 4096
+
+/*
+ * Reads a .maz file (one "x y top bottom left right" line per cell, 1 based)
+ * without Qt. The maze is as wide and tall as the largest cell in the file.
+ * Optional rule lines set the start pose and the goal cells:
+ *   start X Y DIR       DIR is one of U D L R
+ *   goal X Y            one goal cell
+ *   goal X0 Y0 X1 Y1    a rectangle of goal cells
+ * Without them the mouse starts at (1,1) facing up and the goal is the centre.
+ * Short or malformed lines, text after a cell, repeated or missing cells and
+ * walls the two neighbouring cells disagree on are errors. Returns null and
+ * fills error with one "file:line:column: ERROR 201: ..." line per problem.
+ */
+std::shared_ptr<mazeLayout> loadMazeFile(const std::string &path, std::string &error);
+
+/*
+ * Line each cell of a file was on, as runs of cells on one line after
+ * another going up a column or along a row. A file written in either order
+ * costs one run per column or row instead of a number per cell.
+ */
+class cellLines
+{
+public:
+    cellLines() : _run(), _open(false) {}
+
+    //cells have to come in file order
+    void add(int x, int y, int line);
+    //call once after the last add(), before lineOf()
+    void finish();
+    //0 if the cell was never added
+    int lineOf(int x, int y) const;
+
+private:
+    struct lineRun
+    {
+        int x, y;
+        int line;
+        int count;
+        bool alongX;
+    };
+    static int find(const std::vector<lineRun> &runs, int major, int minor, bool alongX);
+
+    std::vector<lineRun> _columns, _rows;
+    lineRun _run;
+    bool _open;
+};
+
+//a file read without the wall and duplicate checks, for mazeLint to judge
+struct mazeFileContents
+{
+    std::shared_ptr<mazeLayout> layout;  //the first of any repeated cells wins
+    std::vector<unsigned long long> given;  //a bit per cell (y*width + x) the file has
+    cellLines lines;
+    std::vector<std::pair<int, int> > duplicates;  //line of each repeated cell and the cell (y*width + x) it repeats
+
+    bool isGiven(int x, int y) const;
+    int lineOf(int x, int y) const { return lines.lineOf(x, y); }
+};
+
+//only syntax and rules out of the maze are errors here
+bool readMazeFile(const std::string &path, mazeFileContents &contents, std::string &error);
+
+//writes the rules and then every cell, the way the editor saves
+bool saveMazeFile(const std::string &path, const mazeLayout &layout, std::string &error);
+
+//rule lines for a layout, empty when it uses the defaults so old files stay unchanged
+std::string mazeRulesText(const mazeLayout &layout);
+
+#endif // MAZEFILE_H
@@ -0,0 +1,263 @@
+#include "mazeLint.h"
+#include <sstream>
+
+typedef unsigned long long word;
+
+static int lowestBit(word bits)
+{
+#if defined(__GNUC__)
+    return __builtin_ctzll(bits);
+#else
+    int bit = 0;
+    while(!((bits >> bit) & 1))
+    {
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+/*
+ * One bit per cell for each side, row y of a plane is words [y*_words, (y+1)*_words),
+ * bit x&63 of word x>>6. Bits past the width are always clear.
+ */
+class wallPlanes
+{
+public:
+    wallPlanes(const mazeFileContents &contents);
+
+    int words() const { return _words; }
+    const word *row(mDirection side, int y) const { return &_planes[side][y*_words]; }
+    const word *known(int y) const { return &_known[y*_words]; }
+    //bits that are cells of a row
+    word valid(int w) const { return w+1 < _words || !(_width & 63) ? ~0ULL : (1ULL << (_width & 63)) - 1; }
+
+private:
+    int _width, _words;
+    std::vector<word> _planes[4];
+    std::vector<word> _known;
+};
+
+wallPlanes::wallPlanes(const mazeFileContents &contents) :
+    _width(contents.layout->width()),
+    _words((contents.layout->width() + 63) / 64)
+{
+    const mazeLayout &layout = *contents.layout;
+    for(int d = 0; d < 4; d++)
+    {
+        _planes[d].assign(_words*layout.height(), 0);
+    }
+    _known.assign(_words*layout.height(), 0);
+    for(int y = 0; y < layout.height(); y++)
+    {
+        for(int x = 0; x < _width; x++)
+        {
+            size_t at = y*_words + (x >> 6);
+            word bit = 1ULL << (x & 63);
+            unsigned char walls = layout.walls(x, y);
+            for(int d = 0; d < 4; d++)
+            {
+                if((walls >> d) & 1)
+                {
+                    _planes[d][at] |= bit;
+                }
+            }
+            if(contents.isGiven(x, y))
+            {
+                _known[at] |= bit;
+            }
+        }
+    }
+}
+
+static const char *sideNames[4] = {"right", "bottom", "left", "top"};
+
+static void addIssue(lintReport &report, lintKind kind, int x, int y, mDirection side, int line, const std::string &text)
+{
+    if(report.issues.size() < LINT_MAX_ISSUES)
+    {
+        lintIssue issue;
+        issue.kind = kind;
+        issue.x = x;
+        issue.y = y;
+        issue.side = side;
+        issue.line = line;
+        issue.text = text;
+        report.issues.push_back(issue);
+    }
+}
+
+//the wall between (x, y) and the cell past its side is only on one of them
+static void oneSided(lintReport &report, const mazeFileContents &contents, int x, int y, mDirection side)
+{
+    const mazeLayout &layout = *contents.layout;
+    int nx = x + stepX(side), ny = y + stepY(side);
+    bool mine = layout.isWall(x, y, side);
+    int hasX = mine ? x : nx, hasY = mine ? y : ny;
+    int lackX = mine ? nx : x, lackY = mine ? ny : y;
+    mDirection hasSide = mine ? side : behind(side);
+
+    std::ostringstream text;
+    text << sideNames[hasSide] << " wall of (" << hasX+1 << ", " << hasY+1 << ") is missing from the "
+         << sideNames[behind(hasSide)] << " of (" << lackX+1 << ", " << lackY+1 << ") on line "
+         << contents.lineOf(lackX, lackY);
+    report.oneSided++;
+    addIssue(report, lONE_SIDED, hasX, hasY, hasSide, contents.lineOf(hasX, hasY), text.str());
+}
+
+static void openEdge(lintReport &report, const mazeFileContents &contents, int x, int y, mDirection side)
+{
+    std::ostringstream text;
+    text << "cell (" << x+1 << ", " << y+1 << ") has no " << sideNames[side] << " wall on the outside of the maze";
+    report.openEdges++;
+    addIssue(report, lOPEN_EDGE, x, y, side, contents.lineOf(x, y), text.str());
+}
+
+//breadth first from the start, a wall on either side of an edge closes it
+static bool goalReachable(const mazeLayout &layout)
+{
+    int width = layout.width(), height = layout.height();
+    std::vector<bool> seen(width*height, false);
+    std::vector<int> queue(1, (layout.startY()-1)*width + layout.startX()-1);
+    seen[queue[0]] = true;
+    for(size_t head = 0; head < queue.size(); head++)
+    {
+        int x = queue[head] % width, y = queue[head] / width;
+        if(layout.isGoal(x, y))
+        {
+            return true;
+        }
+        for(int d = 0; d < 4; d++)
+        {
+            mDirection side = (mDirection)d;
+            int nx = x + stepX(side), ny = y + stepY(side);
+            if(layout.contains(nx, ny) && !seen[ny*width + nx] &&
+               !layout.isWall(x, y, side) && !layout.isWall(nx, ny, behind(side)))
+            {
+                seen[ny*width + nx] = true;
+                queue.push_back(ny*width + nx);
+            }
+        }
+    }
+    return false;
+}
+
+lintReport::lintReport() :
+    oneSided(0),
+    openEdges(0),
+    duplicates(0),
+    missing(0),
+    goalReachable(true)
+{
+}
+
+lintReport lintMaze(const mazeFileContents &contents)
+{
+    lintReport report;
+    const mazeLayout &layout = *contents.layout;
+    int width = layout.width(), height = layout.height();
+    wallPlanes planes(contents);
+    int words = planes.words();
+
+    for(size_t i = 0; i < contents.duplicates.size(); i++)
+    {
+        int cell = contents.duplicates[i].second;
+        std::ostringstream text;
+        text << "cell (" << cell % width + 1 << ", " << cell / width + 1 << ") was already given on line " << contents.lineOf(cell % width, cell / width);
+        report.duplicates++;
+        addIssue(report, lDUPLICATE_CELL, cell % width, cell / width, dUP, contents.duplicates[i].first, text.str());
+    }
+
+    for(int y = 0; y < height; y++)
+    {
+        const word *known = planes.known(y);
+        const word *right = planes.row(dRIGHT, y), *left = planes.row(dLEFT, y);
+        for(int w = 0; w < words; w++)
+        {
+            //missing cells are reported once here and left out of the wall checks
+            for(word bits = ~known[w] & planes.valid(w); bits; bits &= bits - 1)
+            {
+                int x = w*64 + lowestBit(bits);
+                std::ostringstream text;
+                text << "cell (" << x+1 << ", " << y+1 << ") is missing";
+                report.missing++;
+                addIssue(report, lMISSING_CELL, x, y, dUP, 0, text.str());
+            }
+
+            //cell x's right wall against cell x+1's left wall, the next word's low bit carries down
+            word carry = w+1 < words ? known[w+1] << 63 : 0;
+            word pairs = known[w] & ((known[w] >> 1) | carry);
+            word shiftedLeft = (left[w] >> 1) | (w+1 < words ? left[w+1] << 63 : 0);
+            for(word bits = (right[w] ^ shiftedLeft) & pairs; bits; bits &= bits - 1)
+            {
+                oneSided(report, contents, w*64 + lowestBit(bits), y, dRIGHT);
+            }
+
+            //row y's top walls against row y+1's bottom walls
+            if(y+1 < height)
+            {
+                const word *up = planes.row(dUP, y), *down = planes.row(dDOWN, y+1), *above = planes.known(y+1);
+                for(word bits = (up[w] ^ down[w]) & known[w] & above[w]; bits; bits &= bits - 1)
+                {
+                    oneSided(report, contents, w*64 + lowestBit(bits), y, dUP);
+                }
+            }
+        }
+
+        //the two ends of the row
+        if(known[0] & ~left[0] & 1)
+        {
+            openEdge(report, contents, 0, y, dLEFT);
+        }
+        int last = width - 1;
+        if((known[last >> 6] & ~right[last >> 6]) >> (last & 63) & 1)
+        {
+            openEdge(report, contents, last, y, dRIGHT);
+        }
+    }
+
+    //whole bottom and top rows
+    for(int edge = 0; edge < 2; edge++)
+    {
+        int y = edge ? height-1 : 0;
+        mDirection side = edge ? dUP : dDOWN;
+        const word *walls = planes.row(side, y), *known = planes.known(y);
+        for(int w = 0; w < words; w++)
+        {
+            for(word bits = known[w] & ~walls[w]; bits; bits &= bits - 1)
+            {
+                openEdge(report, contents, w*64 + lowestBit(bits), y, side);
+            }
+        }
+    }
+
+    report.goalReachable = goalReachable(layout);
+    if(!report.goalReachable)
+    {
+        std::ostringstream text;
+        text << "no goal cell can be reached from the start (" << layout.startX() << ", " << layout.startY() << ")";
+        addIssue(report, lUNREACHABLE_GOAL, layout.startX()-1, layout.startY()-1, layout.startDir(), 0, text.str());
+    }
+    return report;
+}
+
+std::shared_ptr<mazeLayout> repairMaze(const mazeLayout &layout)
+{
+    int width = layout.width(), height = layout.height();
+    std::shared_ptr<mazeLayout> fixed = std::make_shared<mazeLayout>(width, height);
+    fixed->copyRules(layout);
+    for(int y = 0; y < height; y++)
+    {
+        for(int x = 0; x < width; x++)
+        {
+            for(int d = 0; d < 4; d++)
+            {
+                mDirection side = (mDirection)d;
+                int nx = x + stepX(side), ny = y + stepY(side);
+                bool wall = !layout.contains(nx, ny) || layout.isWall(x, y, side) || layout.isWall(nx, ny, behind(side));
+                fixed->setWall(x, y, side, wall);
+            }
+        }
+    }
+    return fixed;
+}
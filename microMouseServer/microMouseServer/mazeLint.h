@@ -0,0 +1,58 @@
+#ifndef MAZELINT_H
+#define MAZELINT_H
+
+#include "mazeFile.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+//issues listed per maze, the counts in lintReport keep going past it
+#define LINT_MAX_ISSUES 50
+
+enum lintKind
+{
+    lONE_SIDED,         //a wall only one of the two cells has
+    lOPEN_EDGE,         //a gap in the outside wall
+    lDUPLICATE_CELL,    //a cell given twice, the first one is used
+    lMISSING_CELL,      //a cell the file left out
+    lUNREACHABLE_GOAL   //no open path from the start to any goal cell
+};
+
+//cells are 0 based like mazeLayout, line is 0 when the problem is not on one line
+struct lintIssue
+{
+    lintKind kind;
+    int x, y;
+    mDirection side;
+    int line;
+    std::string text;
+};
+
+struct lintReport
+{
+    std::vector<lintIssue> issues;
+    int oneSided;
+    int openEdges;
+    int duplicates;
+    int missing;
+    bool goalReachable;
+
+    lintReport();
+    int total() const { return oneSided + openEdges + duplicates + missing + (goalReachable ? 0 : 1); }
+    bool clean() const { return total() == 0; }
+    //everything but an unreachable goal, which needs a wall taken out by hand
+    bool repairable() const { return goalReachable; }
+};
+
+/*
+ * Checks a maze read with readMazeFile. The walls are split into four bit
+ * planes, one 64 bit word per 64 cells of a row, so both sides of every
+ * shared wall are compared a word at a time. The goal is looked for as if
+ * a wall on either side of an edge closes it.
+ */
+lintReport lintMaze(const mazeFileContents &contents);
+
+//both cells get a wall either of them had and the outside is closed, rules are kept
+std::shared_ptr<mazeLayout> repairMaze(const mazeLayout &layout);
+
+#endif // MAZELINT_H
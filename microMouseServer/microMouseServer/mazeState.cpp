@@ -0,0 +1,330 @@
+#include "mazeState.h"
+
+mazeLayout::mazeLayout(int width, int height) :
+    _width(width),
+    _height(height),
+    _startX(1),
+    _startY(1),
+    _startDir(dUP),
+    _goalCells(0),
+    _wallHash(0),
+    _walls(width*height, 0)
+{
+    setGoal((width-1)/2, (height-1)/2, width/2, height/2);
+}
+
+void mazeLayout::setGoalCell(int x, int y, bool goal)
+{
+    if(isGoal(x, y) == goal)
+    {
+        return;
+    }
+    _wallHash ^= goalKey(x, y);
+    _walls[y*_width + x] ^= GOAL_FLAG;
+    _goalCells += goal ? 1 : -1;
+}
+
+void mazeLayout::setGoal(int x0, int y0, int x1, int y1)
+{
+    clearGoal();
+    for(int x = x0; x <= x1; x++)
+    {
+        for(int y = y0; y <= y1; y++)
+        {
+            if(contains(x, y))
+            {
+                setGoalCell(x, y, true);
+            }
+        }
+    }
+}
+
+void mazeLayout::clearGoal()
+{
+    for(int y = 0; y < _height && _goalCells; y++)
+    {
+        for(int x = 0; x < _width; x++)
+        {
+            setGoalCell(x, y, false);
+        }
+    }
+}
+
+void mazeLayout::setStart(int x, int y, mDirection dir)
+{
+    _startX = x;
+    _startY = y;
+    _startDir = dir;
+}
+
+void mazeLayout::copyRules(const mazeLayout &rules)
+{
+    if(contains(rules.startX()-1, rules.startY()-1))
+    {
+        setStart(rules.startX(), rules.startY(), rules.startDir());
+    }
+    clearGoal();
+    for(int y = 0; y < rules.height() && y < _height; y++)
+    {
+        for(int x = 0; x < rules.width() && x < _width; x++)
+        {
+            setGoalCell(x, y, rules.isGoal(x, y));
+        }
+    }
+}
+
+bool mazeLayout::hasDefaultRules() const
+{
+    mazeLayout plain(_width, _height);
+    if(_startX != plain._startX || _startY != plain._startY || _startDir != plain._startDir || _goalCells != plain._goalCells)
+    {
+        return false;
+    }
+    for(int y = 0; y < _height; y++)
+    {
+        for(int x = 0; x < _width; x++)
+        {
+            if(isGoal(x, y) != plain.isGoal(x, y))
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+unsigned long long mazeLayout::hash() const
+{
+    unsigned long long hash = _wallHash;
+    int head[5] = {_width, _height, _startX, _startY, _startDir};
+    for(int i = 0; i < 5; i++)
+    {
+        hash = mixHash(hash ^ (unsigned int)head[i]);
+    }
+    return hash;
+}
+
+std::shared_ptr<const mazeLayout> mazeLayout::fromNodes(baseMapNode data[][MAZE_HEIGHT], const mazeLayout *rules)
+{
+    std::shared_ptr<mazeLayout> layout = std::make_shared<mazeLayout>(MAZE_WIDTH, MAZE_HEIGHT);
+    if(rules)
+    {
+        layout->copyRules(*rules);
+    }
+    for(int x = 0; x < MAZE_WIDTH; x++)
+    {
+        for(int y = 0; y < MAZE_HEIGHT; y++)
+        {
+            layout->setWalls(x, y, &data[x][y]);
+        }
+    }
+    return layout;
+}
+
+void mazeLayout::setWalls(int x, int y, baseMapNode *node)
+{
+    setWall(x, y, dUP, node->isWallTop());
+    setWall(x, y, dDOWN, node->isWallBottom());
+    setWall(x, y, dLEFT, node->isWallLeft());
+    setWall(x, y, dRIGHT, node->isWallRight());
+}
+
+void mazeLayout::setWall(int x, int y, mDirection side, bool present)
+{
+    if(isWall(x, y, side) != present)
+    {
+        _wallHash ^= wallKey(x, y, side);
+    }
+    if(present)
+    {
+        _walls[y*_width + x] |= (1 << side);
+    }
+    else
+    {
+        _walls[y*_width + x] &= ~(1 << side);
+    }
+}
+
+mouseState::mouseState() :
+    x(1),
+    y(1),
+    dir(dUP),
+    ticks(0),
+    steps(0),
+    turns(0),
+    revisits(0),
+    sensorCalls(0),
+    redundantSensors(0),
+    finished(false),
+    atGoal(false)
+{
+}
+
+knownMap::knownMap(int width, int height) :
+    _width(width),
+    _cells(width*height),
+    _sensedSides(0),
+    _visited((width*height + 63) / 64, 0),
+    _sensed((width*height + 15) / 16, 0)
+{
+}
+
+void knownMap::sense(int x, int y, mDirection side)
+{
+    int cell = y*_width + x;
+    unsigned long long bit = 1ULL << ((cell & 15) * 4 + side);
+    if(!(_sensed[cell >> 4] & bit))
+    {
+        _sensed[cell >> 4] |= bit;
+        _sensedSides++;
+    }
+}
+
+bool knownMap::visit(int x, int y)
+{
+    int bit = y*_width + x;
+    bool seen = (_visited[bit >> 6] >> (bit & 63)) & 1;
+    _visited[bit >> 6] |= 1ULL << (bit & 63);
+    return seen;
+}
+
+simState::simState() :
+    _layout(std::make_shared<mazeLayout>())
+{
+    reset(_layout->startX(), _layout->startY(), _layout->startDir());
+}
+
+simState::simState(std::shared_ptr<const mazeLayout> layout) :
+    _layout(layout)
+{
+    reset(_layout->startX(), _layout->startY(), _layout->startDir());
+}
+
+void simState::setLayout(std::shared_ptr<const mazeLayout> layout)
+{
+    //the map only has to be rebuilt when the maze changes size
+    bool resized = layout->width() != _layout->width() || layout->height() != _layout->height();
+    _layout = layout;
+    if(resized)
+    {
+        reset(_mouse->x, _mouse->y, _mouse->dir);
+    }
+}
+
+void simState::reset(int x, int y, mDirection dir)
+{
+    mouseState start;
+    start.x = x;
+    start.y = y;
+    start.dir = dir;
+    _mouse = cowPtr<mouseState>(start);
+    _known = cowPtr<knownMap>(knownMap(_layout->width(), _layout->height()));
+    if(_layout->contains(x-1, y-1))
+    {
+        _known.edit().visit(x-1, y-1);
+    }
+}
+
+bool simState::wallAt(mDirection side) const
+{
+    int x = _mouse->x - 1, y = _mouse->y - 1;
+    if(!_layout->contains(x, y) || !_layout->contains(x + stepX(side), y + stepY(side)))
+    {
+        //treat the edge of the maze as a wall even if the file left it open
+        return true;
+    }
+    return _layout->isWall(x, y, side);
+}
+
+bool simState::sense(mDirection side)
+{
+    //constant work per call, the map is only written (and copied if shared) the first time a side is seen
+    int x = _mouse->x - 1, y = _mouse->y - 1;
+    mouseState &mouse = _mouse.edit();
+    mouse.sensorCalls++;
+    if(_layout->contains(x, y))
+    {
+        if(_known->isSensed(x, y, side))
+        {
+            mouse.redundantSensors++;
+        }
+        else
+        {
+            knownMap &known = _known.edit();
+            known.sense(x, y, side);
+            //the same wall seen from the next cell
+            int nx = x + stepX(side), ny = y + stepY(side);
+            if(_layout->contains(nx, ny))
+            {
+                known.sense(nx, ny, behind(side));
+            }
+        }
+    }
+    return wallAt(side);
+}
+
+bool simState::isWallLeft()
+{
+    return sense(leftOf(_mouse->dir));
+}
+
+bool simState::isWallRight()
+{
+    return sense(rightOf(_mouse->dir));
+}
+
+bool simState::isWallForward()
+{
+    return sense(_mouse->dir);
+}
+
+bool simState::moveForward()
+{
+    mDirection dir = _mouse->dir;
+    if(wallAt(dir))
+    {
+        return false;
+    }
+
+    mouseState &mouse = _mouse.edit();
+    mouse.x += stepX(dir);
+    mouse.y += stepY(dir);
+    mouse.steps++;
+    //like sense(), a forked map is only copied when this step adds a cell to it
+    if(_known->isVisited(mouse.x-1, mouse.y-1))
+    {
+        mouse.revisits++;
+    }
+    else
+    {
+        _known.edit().visit(mouse.x-1, mouse.y-1);
+    }
+    return true;
+}
+
+void simState::turnLeft()
+{
+    mouseState &mouse = _mouse.edit();
+    mouse.dir = leftOf(mouse.dir);
+    mouse.turns++;
+}
+
+void simState::turnRight()
+{
+    mouseState &mouse = _mouse.edit();
+    mouse.dir = rightOf(mouse.dir);
+    mouse.turns++;
+}
+
+void simState::tick()
+{
+    _mouse.edit().ticks++;
+}
+
+void simState::finish()
+{
+    //the mouse only gets credit if it really is in a goal cell
+    mouseState &mouse = _mouse.edit();
+    mouse.finished = true;
+    mouse.atGoal = _layout->isGoal(mouse.x - 1, mouse.y - 1);
+}
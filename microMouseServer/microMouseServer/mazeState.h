@@ -0,0 +1,206 @@
+#ifndef MAZE_STATE_H
+#define MAZE_STATE_H
+
+#include "mazeConst.h"
+#include "mazeBase.h"
+#include <memory>
+#include <vector>
+
+//turning and stepping helpers, mDirection runs clockwise so right is +1
+inline mDirection rightOf(mDirection dir) { return (mDirection)((dir + 1) % 4); }
+inline mDirection leftOf(mDirection dir) { return (mDirection)((dir + 3) % 4); }
+inline mDirection behind(mDirection dir) { return (mDirection)((dir + 2) % 4); }
+inline int stepX(mDirection dir) { return dir == dRIGHT ? 1 : (dir == dLEFT ? -1 : 0); }
+inline int stepY(mDirection dir) { return dir == dUP ? 1 : (dir == dDOWN ? -1 : 0); }
+
+//splitmix64, gives every (cell, side) its own random Zobrist key without a table
+inline unsigned long long mixHash(unsigned long long val)
+{
+    val += 0x9E3779B97F4A7C15ULL;
+    val = (val ^ (val >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    val = (val ^ (val >> 27)) * 0x94D049BB133111EBULL;
+    return val ^ (val >> 31);
+}
+inline unsigned long long wallKey(int x, int y, mDirection side)
+{
+    return mixHash(((unsigned long long)(unsigned int)x << 34) ^ ((unsigned long long)(unsigned int)y << 2) ^ side);
+}
+//the side field only has room for the four walls, goal cells get keys of their own by salting one
+#define GOAL_SALT 0x676F616C63656C6CULL
+inline unsigned long long goalKey(int x, int y)
+{
+    return mixHash(wallKey(x, y, dRIGHT) ^ GOAL_SALT);
+}
+
+//set next to the wall nibble on goal cells
+#define GOAL_FLAG 0x10
+
+/*
+ * Wall layout of a maze, one nibble per cell indexed by mDirection, plus the
+ * competition rules that go with it: a start pose and a set of goal cells.
+ * Cells are 0 based here (the gui and the mouse use 1 based positions).
+ * Once a layout is handed to a simState it is shared and never modified,
+ * build a new one to edit the maze.
+ */
+class mazeLayout
+{
+public:
+    mazeLayout(int width = MAZE_WIDTH, int height = MAZE_HEIGHT);
+    static std::shared_ptr<const mazeLayout> fromNodes(baseMapNode data[][MAZE_HEIGHT], const mazeLayout *rules = 0);
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+    bool contains(int x, int y) const { return x >= 0 && y >= 0 && x < _width && y < _height; }
+    bool isWall(int x, int y, mDirection side) const { return (_walls[y*_width + x] >> side) & 1; }
+    unsigned char walls(int x, int y) const { return _walls[y*_width + x] & 0xF; }
+
+    void setWall(int x, int y, mDirection side, bool present);
+    void setWalls(int x, int y, baseMapNode *node);
+    //Zobrist hash of the walls and goal cells, kept up to date by setWall and setGoalCell, plus size and start
+    unsigned long long hash() const;
+
+    //the goal is flagged in the cell itself so checking it is one lookup, the centre 2x2 unless set
+    bool isGoal(int x, int y) const { return contains(x, y) && (_walls[y*_width + x] & GOAL_FLAG); }
+    void setGoalCell(int x, int y, bool goal);
+    void setGoal(int x0, int y0, int x1, int y1);
+    void clearGoal();
+    int goalCells() const { return _goalCells; }
+
+    //start pose, 1 based like the mouse, (1,1) facing up unless set
+    int startX() const { return _startX; }
+    int startY() const { return _startY; }
+    mDirection startDir() const { return _startDir; }
+    void setStart(int x, int y, mDirection dir);
+
+    //take the start and goal of another layout, keeping only what fits in this one
+    void copyRules(const mazeLayout &rules);
+    bool hasDefaultRules() const;
+
+private:
+    int _width, _height;
+    int _startX, _startY;
+    mDirection _startDir;
+    int _goalCells;
+    unsigned long long _wallHash;
+    std::vector<unsigned char> _walls;
+};
+
+//everything about a run that changes as the mouse moves
+struct mouseState
+{
+    int x, y;
+    mDirection dir;
+    long ticks;
+    long steps;
+    long turns;
+    long revisits;
+    long sensorCalls;
+    long redundantSensors;
+    bool finished;
+    bool atGoal;        //set by finish(), false if the mouse stopped outside the goal
+
+    mouseState();
+};
+
+/*
+ * What the mouse has found out during the current run: one bit per cell it
+ * has been in, and a nibble per cell (indexed by mDirection like the walls)
+ * of the sides it has sensed. Both are packed into 64 bit words.
+ */
+class knownMap
+{
+public:
+    knownMap(int width = 0, int height = 0);
+
+    bool isVisited(int x, int y) const { return (_visited[(y*_width + x) >> 6] >> ((y*_width + x) & 63)) & 1; }
+    bool visit(int x, int y);
+
+    unsigned sensed(int x, int y) const { return (_sensed[(y*_width + x) >> 4] >> (((y*_width + x) & 15) * 4)) & 0xF; }
+    bool isSensed(int x, int y, mDirection side) const { return (sensed(x, y) >> side) & 1; }
+    bool isExplored(int x, int y) const { return isVisited(x, y) || sensed(x, y); }
+    void sense(int x, int y, mDirection side);
+
+    //share of all cell sides in the maze the mouse knows about
+    double sensedFraction() const { return _cells ? _sensedSides / (4.0 * _cells) : 0; }
+
+private:
+    int _width;
+    int _cells;
+    long _sensedSides;
+    std::vector<unsigned long long> _visited;
+    std::vector<unsigned long long> _sensed;
+};
+
+/*
+ * Shared pointer that copies its payload the first time a shared copy is
+ * written to. Reads never copy.
+ */
+template <class T>
+class cowPtr
+{
+public:
+    cowPtr() : _d(std::make_shared<T>()) {}
+    explicit cowPtr(const T &val) : _d(std::make_shared<T>(val)) {}
+
+    const T &operator*() const { return *_d; }
+    const T *operator->() const { return _d.get(); }
+
+    T &edit()
+    {
+        if(_d.use_count() > 1)
+        {
+            _d = std::make_shared<T>(*_d);
+        }
+        return *_d;
+    }
+
+private:
+    std::shared_ptr<T> _d;
+};
+
+/*
+ * Full state of one simulated run. The maze is shared between all copies,
+ * the mouse and the discovered map are copy on write, so fork() only pays
+ * for what the new branch changes.
+ */
+class simState
+{
+public:
+    simState();
+    explicit simState(std::shared_ptr<const mazeLayout> layout);
+
+    simState fork() const { return *this; }
+
+    void setLayout(std::shared_ptr<const mazeLayout> layout);
+    void reset(int x, int y, mDirection dir);
+
+    const mazeLayout &layout() const { return *_layout; }
+    std::shared_ptr<const mazeLayout> layoutPtr() const { return _layout; }
+    const mouseState &mouse() const { return *_mouse; }
+    const knownMap &known() const { return *_known; }
+
+    int mouseX() const { return _mouse->x; }
+    int mouseY() const { return _mouse->y; }
+    mDirection mouseDir() const { return _mouse->dir; }
+    bool isFinished() const { return _mouse->finished; }
+    bool isAtGoal() const { return _layout->isGoal(_mouse->x - 1, _mouse->y - 1); }
+
+    bool isWallLeft();
+    bool isWallRight();
+    bool isWallForward();
+    bool moveForward();
+    void turnLeft();
+    void turnRight();
+    void tick();
+    void finish();
+
+private:
+    bool wallAt(mDirection side) const;
+    bool sense(mDirection side);
+
+    std::shared_ptr<const mazeLayout> _layout;
+    cowPtr<mouseState> _mouse;
+    cowPtr<knownMap> _known;
+};
+
+#endif
@@ -1,6 +1,10 @@
 #include "mazeConst.h"
 #include "mazegui.h"
 #include<QGraphicsSceneMoveEvent>
+#include<QGraphicsSceneWheelEvent>
+#include<QGraphicsView>
+#include<QImage>
+#include<QtMath>
 
 mazeGui::mazeGui(QObject *parent) :
     QGraphicsScene(parent)
@@ -10,12 +14,26 @@ mazeGui::mazeGui(QObject *parent) :
     this->_guidePen = new QPen(QColor(0xFF,0xFF,0xFF,0x20));
     this->_mousePen = new QPen(QColor(0xFF,0xFF,0x00,0xFF));
     this->_mouseBrush = new QBrush(QColor(0xFF, 0xFF, 0X00, 0xFF));
+    this->_pathPen = new QPen(QColor(0x00,0xFF,0xFF,0x80));
+    this->_pathPen->setWidth(WALL_THICKNESS_PX);
     this->_wallPen->setWidth(WALL_THICKNESS_PX);
     this->_guidePen->setWidth(WALL_THICKNESS_PX);
 
     //initialize graphics groups
     this->_bgGrid = this->createItemGroup(this->selectedItems());
     this->mazeWalls = this->createItemGroup(this->selectedItems());
+    this->_pathLines = this->createItemGroup(this->selectedItems());
+    this->_distances = new distanceOverlay;
+    this->_distances->setZValue(-1);
+    this->addItem(this->_distances);
+    this->_largeMaze = NULL;
+    this->_fog = new fogOverlay;
+    this->_fog->setZValue(1);
+    this->addItem(this->_fog);
+    this->_sweep = new sweepOverlay;
+    this->_sweep->setZValue(-1);
+    this->_sweep->hide();
+    this->addItem(this->_sweep);
     this->_mouse = NULL;
 
     //Generate maze window
@@ -32,13 +50,26 @@ mazeGui::~mazeGui()
     delete _guidePen;
     delete _mousePen;
     delete _mouseBrush;
+    delete _pathPen;
     delete _bgGrid;
     delete mazeWalls;
+    delete _pathLines;
+    delete _distances;
+    delete _largeMaze;
+    delete _fog;
+    delete _sweep;
     delete _mouse;
 }
 
 void mazeGui::mousePressEvent(QGraphicsSceneMouseEvent *mouseEvent)
 {
+    //large mazes are view only, leave the click to the view so it can pan
+    if(this->_largeMaze)
+    {
+        mouseEvent->ignore();
+        return;
+    }
+
     //check if mouse event is a left click inside of the maze
     if(mouseEvent->button() == Qt::LeftButton &&
             mouseEvent->scenePos().x() > 0 &&
@@ -114,6 +145,265 @@ void mazeGui::mousePressEvent(QGraphicsSceneMouseEvent *mouseEvent)
     }
 }
 
+void mazeGui::wheelEvent(QGraphicsSceneWheelEvent *wheelEvent)
+{
+    //zoom every view around the cursor, one notch is 25%
+    qreal factor = qPow(1.25, wheelEvent->delta() / 120.0);
+    foreach(QGraphicsView *view, this->views())
+    {
+        view->setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+        view->scale(factor, factor);
+    }
+    wheelEvent->accept();
+}
+
+void mazeGui::setFog(const simState *state)
+{
+    this->_fog->setState(state);
+}
+
+void mazeGui::updateFog()
+{
+    this->_fog->update();
+}
+
+fogOverlay::fogOverlay() :
+    _state(NULL)
+{
+    this->setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+}
+
+QRectF fogOverlay::boundingRect() const
+{
+    return _bounds;
+}
+
+void fogOverlay::setState(const simState *state)
+{
+    prepareGeometryChange();
+    _state = state;
+    _bounds = state ? QRectF(0, 0, (qreal)state->layout().width()*PX_PER_UNIT, (qreal)state->layout().height()*PX_PER_UNIT) : QRectF();
+    update();
+}
+
+void fogOverlay::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(widget);
+    if(!_state)
+    {
+        return;
+    }
+
+    //same culling as largeMazeItem, one sampled cell per screen pixel when zoomed far out, drawn as one image
+    const knownMap &known = _state->known();
+    QRectF exposed = option->exposedRect.intersected(_bounds);
+    int x0 = qMax(0, (int)qFloor(exposed.left() / PX_PER_UNIT));
+    int y0 = qMax(0, (int)qFloor(exposed.top() / PX_PER_UNIT));
+    int x1 = qMin(_state->layout().width()-1, (int)qFloor(exposed.right() / PX_PER_UNIT));
+    int y1 = qMin(_state->layout().height()-1, (int)qFloor(exposed.bottom() / PX_PER_UNIT));
+    qreal cellPx = PX_PER_UNIT * QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+    int block = cellPx >= 1 ? 1 : qCeil(1.0 / cellPx);
+
+    if(x1 < x0 || y1 < y0)
+    {
+        return;
+    }
+    int cols = (x1 - x0) / block + 1;
+    int rows = (y1 - y0) / block + 1;
+    QImage image(cols, rows, QImage::Format_ARGB32_Premultiplied);
+    for(int row = 0; row < rows; row++)
+    {
+        QRgb *line = (QRgb *)image.scanLine(row);
+        for(int col = 0; col < cols; col++)
+        {
+            line[col] = known.isExplored(x0 + col*block, y0 + row*block) ? qRgba(0, 0, 0, 0) : qRgba(0, 0, 0, 0xA0);
+        }
+    }
+    painter->drawImage(QRectF(x0*PX_PER_UNIT, y0*PX_PER_UNIT, (qreal)cols*block*PX_PER_UNIT, (qreal)rows*block*PX_PER_UNIT), image);
+}
+
+void mazeGui::setLargeMaze(std::shared_ptr<const mazeLayout> layout)
+{
+    this->clearLargeMaze();
+
+    //the per line items are not needed, and with only a handful of items left an index is wasted work
+    this->_bgGrid->hide();
+    this->mazeWalls->hide();
+    this->_pathLines->hide();
+    this->_distances->hide();
+    this->setItemIndexMethod(QGraphicsScene::NoIndex);
+
+    this->_largeMaze = new largeMazeItem(layout, *this->_wallPen, *this->_guidePen);
+    this->_largeMaze->setZValue(-2);
+    this->addItem(this->_largeMaze);
+    this->setSceneRect(this->_largeMaze->boundingRect());
+
+    //start zoomed out to the whole maze
+    foreach(QGraphicsView *view, this->views())
+    {
+        view->setDragMode(QGraphicsView::ScrollHandDrag);
+        qreal factor = qMin(view->viewport()->width() / this->sceneRect().width(),
+                            view->viewport()->height() / this->sceneRect().height());
+        view->setTransform(QTransform::fromScale(factor, -factor));
+        view->centerOn(this->sceneRect().center());
+    }
+}
+
+void mazeGui::clearLargeMaze()
+{
+    if(!this->_largeMaze)
+    {
+        return;
+    }
+    delete this->_largeMaze;
+    this->_largeMaze = NULL;
+
+    this->_bgGrid->show();
+    this->mazeWalls->show();
+    this->_pathLines->show();
+    this->_distances->show();
+    this->setItemIndexMethod(QGraphicsScene::BspTreeIndex);
+    this->setSceneRect(QRectF(QPoint(0,0), QPoint(MAZE_WIDTH_PX,MAZE_HEIGHT_PX)));
+
+    //back to one unit per pixel, keeping the view flipped
+    foreach(QGraphicsView *view, this->views())
+    {
+        view->setDragMode(QGraphicsView::NoDrag);
+        view->setTransform(QTransform::fromScale(1, -1));
+    }
+}
+
+largeMazeItem::largeMazeItem(std::shared_ptr<const mazeLayout> layout, const QPen &wallPen, const QPen &guidePen) :
+    _layout(layout),
+    _wallPen(wallPen),
+    _guidePen(guidePen)
+{
+    //exposedRect is only filled in with this flag set
+    this->setFlag(QGraphicsItem::ItemUsesExtendedStyleOption);
+    _wallPen.setCosmetic(true);
+    _guidePen.setCosmetic(true);
+    _guidePen.setWidth(1);
+}
+
+QRectF largeMazeItem::boundingRect() const
+{
+    return QRectF(0, 0, (qreal)_layout->width()*PX_PER_UNIT, (qreal)_layout->height()*PX_PER_UNIT);
+}
+
+//walls shared by two cells count if either cell has them
+bool largeMazeItem::wallBelow(int x, int y) const
+{
+    return _layout->isWall(x, y, dDOWN) || (y > 0 && _layout->isWall(x, y-1, dUP));
+}
+
+bool largeMazeItem::wallLeftOf(int x, int y) const
+{
+    return _layout->isWall(x, y, dLEFT) || (x > 0 && _layout->isWall(x-1, y, dRIGHT));
+}
+
+void largeMazeItem::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(widget);
+
+    QRectF exposed = option->exposedRect.intersected(this->boundingRect());
+    if(exposed.isEmpty())
+    {
+        return;
+    }
+    int x0 = qMax(0, (int)qFloor(exposed.left() / PX_PER_UNIT));
+    int y0 = qMax(0, (int)qFloor(exposed.top() / PX_PER_UNIT));
+    int x1 = qMin(_layout->width()-1, (int)qFloor(exposed.right() / PX_PER_UNIT));
+    int y1 = qMin(_layout->height()-1, (int)qFloor(exposed.bottom() / PX_PER_UNIT));
+    qreal cellPx = PX_PER_UNIT * QStyleOptionGraphicsItem::levelOfDetailFromTransform(painter->worldTransform());
+
+    if(cellPx >= 3)
+    {
+        this->paintLines(painter, x0, y0, x1, y1, cellPx);
+    }
+    else
+    {
+        this->paintDensity(painter, x0, y0, x1, y1, cellPx);
+    }
+}
+
+void largeMazeItem::paintLines(QPainter *painter, int x0, int y0, int x1, int y1, qreal cellPx)
+{
+    //the guide grid only helps once cells are big enough to click on
+    if(cellPx >= 8)
+    {
+        QVector<QLineF> guides;
+        for(int x = x0; x <= x1+1; x++)
+        {
+            guides.append(QLineF(x*PX_PER_UNIT, y0*PX_PER_UNIT, x*PX_PER_UNIT, (y1+1)*PX_PER_UNIT));
+        }
+        for(int y = y0; y <= y1+1; y++)
+        {
+            guides.append(QLineF(x0*PX_PER_UNIT, y*PX_PER_UNIT, (x1+1)*PX_PER_UNIT, y*PX_PER_UNIT));
+        }
+        painter->setPen(_guidePen);
+        painter->drawLines(guides);
+    }
+
+    //every cell draws its bottom and left wall, the last row and column also close the top and right
+    QVector<QLineF> walls;
+    for(int y = y0; y <= y1; y++)
+    {
+        for(int x = x0; x <= x1; x++)
+        {
+            if(wallBelow(x, y))
+            {
+                walls.append(QLineF(x*PX_PER_UNIT, y*PX_PER_UNIT, (x+1)*PX_PER_UNIT, y*PX_PER_UNIT));
+            }
+            if(wallLeftOf(x, y))
+            {
+                walls.append(QLineF(x*PX_PER_UNIT, y*PX_PER_UNIT, x*PX_PER_UNIT, (y+1)*PX_PER_UNIT));
+            }
+            if(y == y1 && (y+1 == _layout->height() ? _layout->isWall(x, y, dUP) : wallBelow(x, y+1)))
+            {
+                walls.append(QLineF(x*PX_PER_UNIT, (y+1)*PX_PER_UNIT, (x+1)*PX_PER_UNIT, (y+1)*PX_PER_UNIT));
+            }
+            if(x == x1 && (x+1 == _layout->width() ? _layout->isWall(x, y, dRIGHT) : wallLeftOf(x+1, y)))
+            {
+                walls.append(QLineF((x+1)*PX_PER_UNIT, y*PX_PER_UNIT, (x+1)*PX_PER_UNIT, (y+1)*PX_PER_UNIT));
+            }
+        }
+    }
+    painter->setPen(_wallPen);
+    painter->drawLines(walls);
+}
+
+void largeMazeItem::paintDensity(QPainter *painter, int x0, int y0, int x1, int y1, qreal cellPx)
+{
+    //one image pixel per block of cells, brightness is the share of walls in the block
+    int block = qCeil(1.0 / cellPx);
+    int cols = (x1 - x0) / block + 1;
+    int rows = (y1 - y0) / block + 1;
+
+    //big blocks are sampled on a 4x4 grid so a frame never looks at more than 16 cells per pixel
+    int stride = (block + 3) / 4;
+    QImage image(cols, rows, QImage::Format_RGB32);
+    for(int row = 0; row < rows; row++)
+    {
+        QRgb *line = (QRgb *)image.scanLine(row);
+        for(int col = 0; col < cols; col++)
+        {
+            int walls = 0, cells = 0;
+            int bx = x0 + col*block, by = y0 + row*block;
+            for(int y = by; y < by + block && y <= y1; y += stride)
+            {
+                for(int x = bx; x < bx + block && x <= x1; x += stride)
+                {
+                    walls += wallBelow(x, y) + wallLeftOf(x, y);
+                    cells++;
+                }
+            }
+            int shade = cells ? 0xFF * walls / (2*cells) : 0;
+            line[col] = qRgb(shade, shade, shade);
+        }
+    }
+    painter->drawImage(QRectF(x0*PX_PER_UNIT, y0*PX_PER_UNIT, (qreal)cols*block*PX_PER_UNIT, (qreal)rows*block*PX_PER_UNIT), image);
+}
+
 QPen mazeGui::wallPen()
 {
     return *_wallPen;
@@ -133,6 +423,204 @@ void mazeGui::drawGuideLines()
     }
 }
 
+void mazeGui::drawPath(const plannedPath &path)
+{
+    //same clear and redraw as the walls, the path is only a few dozen lines
+    this->removeItem(this->_pathLines);
+    while (this->_pathLines->childItems().size()>0)
+    {
+       delete (this->_pathLines->childItems().first());
+    }
+    this->addItem(this->_pathLines);
+
+    for(size_t i = 1; i < path.steps.size(); i++)
+    {
+        const pathStep &from = path.steps[i-1];
+        const pathStep &to = path.steps[i];
+        this->_pathLines->addToGroup(this->addLine(QLineF((from.x-0.5)*PX_PER_UNIT, (from.y-0.5)*PX_PER_UNIT,
+                                                          (to.x-0.5)*PX_PER_UNIT, (to.y-0.5)*PX_PER_UNIT), *_pathPen));
+    }
+}
+
+void mazeGui::drawDistances(const dynamicPath &field, const std::vector<pathStep> &path)
+{
+    this->_distances->setField(field, path);
+}
+
+void mazeGui::drawSweep(const sweepMap &map)
+{
+    //both overlays number every cell, only show one of them
+    this->_sweep->setMap(map);
+    this->_sweep->show();
+    this->_distances->hide();
+}
+
+void mazeGui::clearSweep()
+{
+    if(this->_sweep->isVisible())
+    {
+        this->_sweep->hide();
+        this->_distances->setVisible(!this->isLargeMaze());
+    }
+}
+
+sweepOverlay::sweepOverlay() :
+    _width(0),
+    _height(0)
+{
+}
+
+QRectF sweepOverlay::boundingRect() const
+{
+    return QRectF(0, 0, _width*PX_PER_UNIT, _height*PX_PER_UNIT);
+}
+
+void sweepOverlay::setMap(const sweepMap &map)
+{
+    if(map.width() != _width || map.height() != _height)
+    {
+        prepareGeometryChange();
+    }
+    _width = map.width();
+    _height = map.height();
+    _successes.resize(_width*_height);
+    _steps.resize(_width*_height);
+    for(int y = 0; y < _height; y++)
+    {
+        for(int x = 0; x < _width; x++)
+        {
+            _successes[y*_width + x] = map.successes(x, y);
+            _steps[y*_width + x] = map.meanSteps(x, y);
+        }
+    }
+    update();
+}
+
+void sweepOverlay::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    //red where no heading gets to the goal through to green where all four do
+    painter->setPen(Qt::NoPen);
+    for(int y = 0; y < _height; y++)
+    {
+        for(int x = 0; x < _width; x++)
+        {
+            painter->setBrush(QColor::fromHsv(30*_successes[y*_width + x], 0xFF, 0xFF, 0x50));
+            painter->drawRect(QRectF(x*PX_PER_UNIT, y*PX_PER_UNIT, PX_PER_UNIT, PX_PER_UNIT));
+        }
+    }
+
+    //headings that made it over the mean steps they took, flipped back like the distances
+    QFont font = painter->font();
+    font.setPixelSize(PX_PER_UNIT/4);
+    painter->setFont(font);
+    painter->setPen(QColor(0xFF,0xFF,0xFF,0x90));
+    for(int y = 0; y < _height; y++)
+    {
+        for(int x = 0; x < _width; x++)
+        {
+            QString text = QString("%1/4").arg(_successes[y*_width + x]);
+            if(_steps[y*_width + x] >= 0)
+            {
+                text += QString("\n%1").arg(_steps[y*_width + x], 0, 'f', 0);
+            }
+            painter->save();
+            painter->translate(x*PX_PER_UNIT, (y+1)*PX_PER_UNIT);
+            painter->scale(1, -1);
+            painter->drawText(QRectF(0, 0, PX_PER_UNIT, PX_PER_UNIT), Qt::AlignCenter, text);
+            painter->restore();
+        }
+    }
+}
+
+distanceOverlay::distanceOverlay() :
+    _width(0),
+    _height(0),
+    _maxDist(1)
+{
+}
+
+QRectF distanceOverlay::boundingRect() const
+{
+    return QRectF(0, 0, _width*PX_PER_UNIT, _height*PX_PER_UNIT);
+}
+
+void distanceOverlay::setField(const dynamicPath &field, const std::vector<pathStep> &path)
+{
+    if(field.width() != _width || field.height() != _height)
+    {
+        prepareGeometryChange();
+    }
+    _width = field.width();
+    _height = field.height();
+    _dist = field.distances();
+    _path = path;
+    _maxDist = 1;
+    for(size_t i = 0; i < _dist.size(); i++)
+    {
+        if(_dist[i] < DIST_UNREACHABLE && _dist[i] > _maxDist)
+        {
+            _maxDist = _dist[i];
+        }
+    }
+    update();
+}
+
+void distanceOverlay::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget)
+{
+    Q_UNUSED(option);
+    Q_UNUSED(widget);
+
+    //shade each cell from green near the goal to red far away, unreachable cells stay dark
+    painter->setPen(Qt::NoPen);
+    for(int y = 0; y < _height; y++)
+    {
+        for(int x = 0; x < _width; x++)
+        {
+            int dist = _dist[y*_width + x];
+            if(dist >= DIST_UNREACHABLE)
+            {
+                continue;
+            }
+            painter->setBrush(QColor::fromHsv(120 - 120*dist/_maxDist, 0xFF, 0xFF, 0x30));
+            painter->drawRect(QRectF(x*PX_PER_UNIT, y*PX_PER_UNIT, PX_PER_UNIT, PX_PER_UNIT));
+        }
+    }
+
+    //the view is flipped upside down, flip the numbers back
+    QFont font = painter->font();
+    font.setPixelSize(PX_PER_UNIT/3);
+    painter->setFont(font);
+    painter->setPen(QColor(0xFF,0xFF,0xFF,0x60));
+    for(int y = 0; y < _height; y++)
+    {
+        for(int x = 0; x < _width; x++)
+        {
+            int dist = _dist[y*_width + x];
+            if(dist >= DIST_UNREACHABLE)
+            {
+                continue;
+            }
+            painter->save();
+            painter->translate(x*PX_PER_UNIT, (y+1)*PX_PER_UNIT);
+            painter->scale(1, -1);
+            painter->drawText(QRectF(0, 0, PX_PER_UNIT, PX_PER_UNIT), Qt::AlignCenter, QString::number(dist));
+            painter->restore();
+        }
+    }
+
+    QPen pathPen(QColor(0x00,0xFF,0x00,0xA0));
+    pathPen.setWidth(WALL_THICKNESS_PX);
+    painter->setPen(pathPen);
+    for(size_t i = 1; i < _path.size(); i++)
+    {
+        painter->drawLine(QLineF((_path[i-1].x-0.5)*PX_PER_UNIT, (_path[i-1].y-0.5)*PX_PER_UNIT,
+                                 (_path[i].x-0.5)*PX_PER_UNIT, (_path[i].y-0.5)*PX_PER_UNIT));
+    }
+}
+
 void mazeGui::drawMaze(baseMapNode data[][MAZE_HEIGHT])
 {
     //delete old maze walls from GUI
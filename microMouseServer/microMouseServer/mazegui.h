@@ -1,6 +1,10 @@
 #ifndef MAZEGUI_H
 #define MAZEGUI_H
 #include "mazeBase.h"
+#include "pathPlanner.h"
+#include "dynamicPath.h"
+#include "sweep.h"
+#include <memory>
 #include <QLineF>
 #include <QPen>
 #include <QGraphicsScene>
@@ -10,6 +14,74 @@
 #include <QPoint>
 #include <QStyleOptionGraphicsItem>
 
+//distance to the goal of every cell and the shortest path, painted by one item so edits only repaint
+class distanceOverlay : public QGraphicsItem
+{
+public:
+    distanceOverlay();
+    QRectF boundingRect() const;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
+    void setField(const dynamicPath &field, const std::vector<pathStep> &path);
+
+private:
+    int _width, _height;
+    int _maxDist;
+    std::vector<int> _dist;
+    std::vector<pathStep> _path;
+};
+
+/*
+ * Draws a whole maze of any size as one item, only the cells inside the
+ * exposed rect are visited. Zoomed out past a few pixels per cell the walls
+ * are reduced to a density image with one pixel per block of cells.
+ */
+class largeMazeItem : public QGraphicsItem
+{
+public:
+    largeMazeItem(std::shared_ptr<const mazeLayout> layout, const QPen &wallPen, const QPen &guidePen);
+    QRectF boundingRect() const;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
+
+private:
+    void paintLines(QPainter *painter, int x0, int y0, int x1, int y1, qreal cellPx);
+    void paintDensity(QPainter *painter, int x0, int y0, int x1, int y1, qreal cellPx);
+    bool wallBelow(int x, int y) const;
+    bool wallLeftOf(int x, int y) const;
+
+    std::shared_ptr<const mazeLayout> _layout;
+    QPen _wallPen;
+    QPen _guidePen;
+};
+
+//darkens every cell the mouse has neither been in nor sensed a wall of, read live from the run
+class fogOverlay : public QGraphicsItem
+{
+public:
+    fogOverlay();
+    QRectF boundingRect() const;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
+    void setState(const simState *state);
+
+private:
+    const simState *_state;
+    QRectF _bounds;
+};
+
+//how many of the four headings reach the goal from each cell and the mean steps they take
+class sweepOverlay : public QGraphicsItem
+{
+public:
+    sweepOverlay();
+    QRectF boundingRect() const;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget);
+    void setMap(const sweepMap &map);
+
+private:
+    int _width, _height;
+    std::vector<int> _successes;
+    std::vector<double> _steps;
+};
+
 class mazeGui : public QGraphicsScene
 {
     Q_OBJECT
@@ -17,6 +89,7 @@ public:
     explicit mazeGui(QObject *parent = 0);
     ~mazeGui();
     virtual void mousePressEvent(QGraphicsSceneMouseEvent * mouseEvent);
+    virtual void wheelEvent(QGraphicsSceneWheelEvent * wheelEvent);
     QPen wallPen();
 
     QGraphicsItemGroup *mazeWalls;
@@ -24,6 +97,15 @@ public:
     void drawMaze(baseMapNode data[][MAZE_HEIGHT]);
     void drawMouse(QPoint cell, mDirection direction);
     void drawGuideLines();
+    void drawPath(const plannedPath &path);
+    void drawDistances(const dynamicPath &field, const std::vector<pathStep> &path);
+    void drawSweep(const sweepMap &map);
+    void clearSweep();
+    void setFog(const simState *state);
+    void updateFog();
+    void setLargeMaze(std::shared_ptr<const mazeLayout> layout);
+    void clearLargeMaze();
+    bool isLargeMaze() const { return _largeMaze != NULL; }
 
     int mouseX();
     int mouseY();
@@ -46,10 +128,16 @@ public slots:
 
 private:
     QGraphicsItemGroup *_bgGrid;
+    QGraphicsItemGroup *_pathLines;
+    distanceOverlay *_distances;
+    largeMazeItem *_largeMaze;
+    fogOverlay *_fog;
+    sweepOverlay *_sweep;
     QGraphicsEllipseItem *_mouse;
     QPen *_wallPen;
     QPen *_guidePen;
     QPen *_mousePen;
+    QPen *_pathPen;
     QBrush *_mouseBrush;
     QPoint _mousePos;
     mDirection _mouseDir;
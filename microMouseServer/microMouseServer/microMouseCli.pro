@@ -0,0 +1,51 @@
+#-------------------------------------------------
+#
+# Headless runner, plain C++ with no Qt libraries so it
+# starts instantly and runs without a display.
+#
+#-------------------------------------------------
+
+QT       -= core gui
+CONFIG   -= qt app_bundle
+CONFIG   += console thread c++17
+
+TARGET = microMouseCli
+TEMPLATE = app
+
+
+SOURCES += climain.cpp \
+    mazeBase.cpp \
+    mazeState.cpp \
+    mazeFile.cpp \
+    runStats.cpp \
+    runLog.cpp \
+    lzBlock.cpp \
+    motionScore.cpp \
+    pathPlanner.cpp \
+    mouseAI.cpp \
+    builtinai.cpp \
+    batchRun.cpp \
+    resultCache.cpp \
+    competition.cpp \
+    sweep.cpp \
+    spectator.cpp \
+    studentai.cpp
+
+
+HEADERS  += mazeConst.h \
+    mazeBase.h \
+    mazeState.h \
+    mazeFile.h \
+    runStats.h \
+    runLog.h \
+    lzBlock.h \
+    motionScore.h \
+    pathPlanner.h \
+    mouseAI.h \
+    builtinai.h \
+    batchRun.h \
+    resultCache.h \
+    competition.h \
+    sweep.h \
+    spectator.h \
+    studentai.h
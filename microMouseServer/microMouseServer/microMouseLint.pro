@@ -0,0 +1,27 @@
+#-------------------------------------------------
+#
+# Maze lint, checks directories of .maz files in
+# parallel and can write repaired copies back.
+#
+#-------------------------------------------------
+
+QT       -= core gui
+CONFIG   -= qt app_bundle
+CONFIG   += console thread c++17
+
+TARGET = microMouseLint
+TEMPLATE = app
+
+
+SOURCES += lintmain.cpp \
+    mazeBase.cpp \
+    mazeState.cpp \
+    mazeFile.cpp \
+    mazeLint.cpp
+
+
+HEADERS  += mazeConst.h \
+    mazeBase.h \
+    mazeState.h \
+    mazeFile.h \
+    mazeLint.h
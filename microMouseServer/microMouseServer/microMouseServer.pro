@@ -4,24 +4,50 @@
 #
 #-------------------------------------------------
 
-QT       += core gui
+QT       += core gui concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
 TARGET = microMouseServer
 TEMPLATE = app
+CONFIG += c++17
 
 
 SOURCES += mazegui.cpp\
         main.cpp \
         micromouseserver.cpp \
     mazeBase.cpp \
-    studentai.cpp
+    studentai.cpp \
+    mazeState.cpp \
+    runStats.cpp \
+    runLog.cpp \
+    lzBlock.cpp \
+    motionScore.cpp \
+    pathPlanner.cpp \
+    mouseAI.cpp \
+    dynamicPath.cpp \
+    mazeFile.cpp \
+    mazeLint.cpp \
+    sweep.cpp \
+    spectator.cpp
 
 
 HEADERS  += micromouseserver.h \
     mazeConst.h \
     mazeBase.h \
-    mazegui.h
+    mazegui.h \
+    mazeState.h \
+    runStats.h \
+    runLog.h \
+    lzBlock.h \
+    motionScore.h \
+    pathPlanner.h \
+    mouseAI.h \
+    studentai.h \
+    dynamicPath.h \
+    mazeFile.h \
+    mazeLint.h \
+    sweep.h \
+    spectator.h
 
 FORMS    += micromouseserver.ui
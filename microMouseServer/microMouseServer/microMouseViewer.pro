@@ -0,0 +1,24 @@
+#-------------------------------------------------
+#
+# Spectator client, connects to the stream of a running
+# simulator or microMouseCli and draws it in the terminal.
+#
+#-------------------------------------------------
+
+QT       -= core gui
+CONFIG   -= qt app_bundle
+CONFIG   += console c++17
+
+TARGET = microMouseViewer
+TEMPLATE = app
+
+
+SOURCES += viewer.cpp \
+    mazeBase.cpp
+
+
+HEADERS  += mazeConst.h \
+    mazeBase.h \
+    mazeState.h \
+    mouseAI.h \
+    spectator.h
@@ -2,20 +2,41 @@
 #include "ui_micromouseserver.h"
 #include "mazeConst.h"
 #include "mazegui.h"
+#include "mazeLint.h"
 #include <QFileDialog>
 #include <QFile>
 #include <QTextStream>
+#include <QFileInfo>
+#include <QTextDocument>
+#include <QtConcurrent/QtConcurrentRun>
 
 
-microMouseServer::microMouseServer(QWidget *parent) :
+microMouseServer::microMouseServer(QWidget *parent, const QString &spectatePath) :
     QMainWindow(parent),
-    ui(new Ui::microMouseServer)
+    ui(new Ui::microMouseServer),
+    _mazeName("untitled")
 {
     maze = new mazeGui;
     _comTimer = new QTimer(this);
     _aiCallTimer = new QTimer(this);
+    _printTimer = new QTimer(this);
+    _printTimer->setSingleShot(true);
+    _sweepWatcher = new QFutureWatcher<sweepMap>(this);
     ui->setupUi(this);
     connectSignals();
+    _recorder.setScorer(&_scorer);
+    _recorder.setPlanner(&_costs);
+
+    //old lines scroll away, a long run can not make the window grow without end
+    ui->txt_status->document()->setMaximumBlockCount(_statusLines);
+    ui->txt_debug->document()->setMaximumBlockCount(_statusLines);
+
+    //anyone on this machine can watch with microMouseViewer
+    std::string error;
+    if(!_stream.listen(spectatePath.toLocal8Bit().toStdString(), error))
+    {
+        ui->txt_debug->append(QString::fromStdString(error));
+    }
 
     ui->graphics->scale(1,-1);
     ui->graphics->setBackgroundBrush(QBrush(Qt::black));
@@ -23,6 +44,7 @@ microMouseServer::microMouseServer(QWidget *parent) :
     ui->graphics->setScene(maze);
 
     this->initMaze();
+    this->syncMaze();
     this->maze->drawGuideLines();
     this->maze->drawMaze(this->mazeData);
 
@@ -31,6 +53,8 @@ microMouseServer::microMouseServer(QWidget *parent) :
 
 microMouseServer::~microMouseServer()
 {
+    //the sweep threads still use the maze
+    _sweepWatcher->waitForFinished();
     delete ui;
     delete _comTimer;
     delete maze;
@@ -51,9 +75,12 @@ void microMouseServer::connectSignals()
     connect(ui->menu_saveMaze, SIGNAL(triggered()), this, SLOT(saveMaze()));
     connect(ui->menu_connect2Mouse, SIGNAL(triggered()), this, SLOT(connect2mouse()));
     connect(ui->menu_startRun, SIGNAL(triggered()), this, SLOT(startAI()));
+    connect(ui->menu_sweep, SIGNAL(triggered()), this, SLOT(sweepAI()));
 
     connect(_comTimer, SIGNAL(timeout()), this, SLOT(netComs()));
-    connect(_aiCallTimer, SIGNAL(timeout()), this, SLOT(studentAI()));
+    connect(_aiCallTimer, SIGNAL(timeout()), this, SLOT(runAI()));
+    connect(_printTimer, SIGNAL(timeout()), this, SLOT(showDroppedPrints()));
+    connect(_sweepWatcher, SIGNAL(finished()), this, SLOT(sweepDone()));
 
     connect(this->maze, SIGNAL(passTopWall(QPoint)), this, SLOT(addTopWall(QPoint)));
     connect(this->maze, SIGNAL(passBottomWall(QPoint)), this, SLOT(addBottomWall(QPoint)));
@@ -79,114 +106,91 @@ void microMouseServer::loadMaze()
     //open file find window
     QString fileName = QFileDialog::getOpenFileName(this,
              tr("Open Maze File"), "./", tr("Maze Files (*.maz)"));
-    QFile inFile(fileName);
-
-    //if the file can't be opened throw error to ui
-    if (!inFile.open(QIODevice::ReadOnly | QIODevice::Text))
+    if(fileName.isEmpty())
     {
-        ui->txt_debug->append("ERROR 202: file not found");
         return;
     }
 
-    //read maze
-    QTextStream mazeFile(&inFile);
-
-    int largestX =0, largestY=0;
-    int x, y, wallTop, wallBottom, wallLeft,wallRight;
-    while(!mazeFile.atEnd())
+    //read maze, then lint it so walls the file got wrong are pointed out instead of refusing the whole maze
+    std::string error;
+    mazeFileContents contents;
+    if(!readMazeFile(fileName.toLocal8Bit().toStdString(), contents, error))
     {
-        mazeFile >> x;
-        mazeFile >> y;
-        mazeFile >> wallTop;
-        mazeFile >> wallBottom;
-        mazeFile >> wallLeft;
-        mazeFile >> wallRight;
-
-        //check formating
-        if(x<0 || y<0 || wallTop<0 || wallBottom<0 || wallLeft<0 || wallRight<0 ||
-           wallTop>1 || wallBottom>1 || wallLeft>1 || wallRight>1)
-        {
-            ui->txt_debug->append("ERROR 201: file formating error");
-            return;
-        }
-
-        //check x boundary
-        if(x > largestX)
-        {
-            if(x > MAZE_WIDTH)
-            {
-                ui->txt_debug->append("ERROR 204: maze file is wider than max maze size");
-            }
-            else
-            {
-                largestX = x;
-            }
-        }
-
-        //check y boundary
-        if(y > largestY)
-        {
-            if(y > MAZE_HEIGHT)
-            {
-                ui->txt_debug->append("ERROR 205: maze file is taller than max maze size");
-            }
-            else
-            {
-                largestY = y;
-            }
-        }
-
-        baseMapNode *mover = &this->mazeData[x-1][y-1];
-        //load data into maze
-        mover->setXY(x,y);
-
-        if(wallLeft)
-        {
-             mover->setWall(LEFT, NULL);
-        }
-        else
-        {
-            //mover->setWall(LEFT, &this->mazeData[x-1][y]);
-        }
+        ui->txt_debug->append(QString::fromStdString(error));
+        return;
+    }
+    std::shared_ptr<mazeLayout> layout = contents.layout;
+    this->lintLoaded(fileName, contents);
+    this->_mazeName = QFileInfo(fileName).fileName();
 
-        if(wallRight)
-        {
-            mover->setWall(RIGHT, NULL);
-        }
-        else
-        {
-            //mover->setWall(RIGHT, &this->mazeData[x+1][y]);
-        }
-        if(wallTop)
-        {
-            mover->setWall(TOP, NULL);
-        }
-        else
-        {
-            //mover->setWall(TOP, &this->mazeData[x][y+1]);
-        }
+    //too big for the editor, show it read only with the culled renderer
+    if(layout->width() > MAZE_WIDTH || layout->height() > MAZE_HEIGHT)
+    {
+        _aiCallTimer->stop();
+        this->_recorder.setPlanner(NULL);
+        this->_sim.setLayout(layout);
+        this->_sim.reset(layout->startX(), layout->startY(), layout->startDir());
+        this->_stream.setMaze(*layout);
+        this->maze->setLargeMaze(layout);
+        this->maze->setFog(NULL);
+        this->drawMouse();
+        ui->txt_debug->append(QString("Maze loaded, %1x%2 is too large to edit").arg(layout->width()).arg(layout->height()));
+        return;
+    }
 
-        if(wallBottom)
-        {
-            mover->setWall(BOTTOM, NULL);
-        }
-        else
+    //load data into maze, starting from an empty one so nothing is left from the last file
+    this->maze->clearLargeMaze();
+    this->_recorder.setPlanner(&this->_costs);
+    this->initMaze();
+    for(int x = 0; x < layout->width(); x++)
+    {
+        for(int y = 0; y < layout->height(); y++)
         {
-            //mover->setWall(BOTTOM, &this->mazeData[x][y-1]);
+            baseMapNode *mover = &this->mazeData[x][y];
+            mover->setWall(TOP, layout->isWall(x, y, dUP) || y+1 >= MAZE_HEIGHT ? NULL : &this->mazeData[x][y+1]);
+            mover->setWall(BOTTOM, layout->isWall(x, y, dDOWN) || y == 0 ? NULL : &this->mazeData[x][y-1]);
+            mover->setWall(LEFT, layout->isWall(x, y, dLEFT) || x == 0 ? NULL : &this->mazeData[x-1][y]);
+            mover->setWall(RIGHT, layout->isWall(x, y, dRIGHT) || x+1 >= MAZE_WIDTH ? NULL : &this->mazeData[x+1][y]);
         }
     }
     ui->txt_debug->append("Maze loaded");
-    mazeFile.flush();
-    inFile.close();
 
-    //draw maze and mouse
+    //draw maze and mouse, the editor keeps the start and goal from the file
+    this->maze->clearSweep();
+    this->_sim.setLayout(layout);
+    this->syncMaze();
+    this->_sim.reset(layout->startX(), layout->startY(), layout->startDir());
+    this->maze->setFog(NULL);
     this->maze->drawMaze(this->mazeData);
-    this->maze->drawMouse(QPoint(1,1),dUP);
+    this->drawMouse();
 }
 
+void microMouseServer::lintLoaded(const QString &fileName, const mazeFileContents &contents)
+{
+    lintReport lint = lintMaze(contents);
+    for(size_t i = 0; i < lint.issues.size() && (int)i < _lintShown; i++)
+    {
+        QString where = lint.issues[i].line ? QString("line %1: ").arg(lint.issues[i].line) : QString();
+        ui->txt_debug->append(QString("ERROR 212: ") + where + QString::fromStdString(lint.issues[i].text));
+    }
+    if(lint.total() > _lintShown)
+    {
+        ui->txt_debug->append(QString("%1 more problems, microMouseLint %2 lists them all").arg(lint.total() - _lintShown).arg(QFileInfo(fileName).fileName()));
+    }
+    if(!lint.clean() && lint.repairable())
+    {
+        ui->txt_debug->append("microMouseLint --fix can repair this maze");
+    }
+}
 
 void microMouseServer::saveMaze()
 {
+    if(this->maze->isLargeMaze())
+    {
+        ui->txt_debug->append("ERROR 208: large mazes are view only and can not be saved");
+        return;
+    }
+
     //open file save window
     QString fileName = QFileDialog::getSaveFileName(this,
              tr("Select Maze File"), "", tr("Maze Files (*.maz)"));
@@ -202,6 +206,7 @@ void microMouseServer::saveMaze()
     {
         QTextStream mazeFile(&inFile);
 
+        mazeFile << QString::fromStdString(mazeRulesText(this->_sim.layout()));
         for(int i = 0; i < MAZE_WIDTH; i++)
         {
             for(int j = 0; j < MAZE_HEIGHT; j++)
@@ -276,6 +281,7 @@ void microMouseServer::removeRightWall(QPoint cell)
         this->mazeData[cell.x()][cell.y()].setWall(RIGHT, &this->mazeData[cell.x()+1][cell.y()]);
         this->mazeData[cell.x()+1][cell.y()].setWall(LEFT, &this->mazeData[cell.x()][cell.y()]);
     }
+    this->commitEdit(cell);
     this->maze->drawMaze(this->mazeData);
 }
 
@@ -286,6 +292,7 @@ void microMouseServer::removeLeftWall(QPoint cell)
         this->mazeData[cell.x()][cell.y()].setWall(LEFT, &this->mazeData[cell.x()-1][cell.y()]);
         this->mazeData[cell.x()-1][cell.y()].setWall(RIGHT, &this->mazeData[cell.x()][cell.y()]);
     }
+    this->commitEdit(cell);
     this->maze->drawMaze(this->mazeData);
 }
 
@@ -296,6 +303,7 @@ void microMouseServer::removeTopWall(QPoint cell)
         this->mazeData[cell.x()][cell.y()].setWall(TOP, &this->mazeData[cell.x()][cell.y()+1]);
         this->mazeData[cell.x()][cell.y()+1].setWall(BOTTOM, &this->mazeData[cell.x()][cell.y()]);
     }
+    this->commitEdit(cell);
     this->maze->drawMaze(this->mazeData);
 }
 
@@ -306,6 +314,7 @@ void microMouseServer::removeBottomWall(QPoint cell)
         this->mazeData[cell.x()][cell.y()].setWall(BOTTOM, &this->mazeData[cell.x()][cell.y()-1]);
         this->mazeData[cell.x()][cell.y()-1].setWall(TOP, &this->mazeData[cell.x()][cell.y()]);
     }
+    this->commitEdit(cell);
     this->maze->drawMaze(this->mazeData);
 }
 
@@ -313,20 +322,23 @@ void microMouseServer::addLeftWall(QPoint cell)
 {
     this->mazeData[cell.x()][cell.y()].setWall(LEFT, NULL);
     if(cell.x() > 0)this->mazeData[cell.x()-1][cell.y()].setWall(RIGHT,NULL);
+    this->commitEdit(cell);
     this->maze->drawMaze(this->mazeData);
 }
 
 void microMouseServer::addRightWall(QPoint cell)
 {
     this->mazeData[cell.x()][cell.y()].setWall(RIGHT, NULL);
-    if(cell.x() < MAZE_WIDTH )this->mazeData[cell.x()+1][cell.y()].setWall(LEFT, NULL);
+    if(cell.x() < MAZE_WIDTH-1)this->mazeData[cell.x()+1][cell.y()].setWall(LEFT, NULL);
+    this->commitEdit(cell);
     this->maze->drawMaze(this->mazeData);
 }
 
 void microMouseServer::addTopWall(QPoint cell)
 {
     this->mazeData[cell.x()][cell.y()].setWall(TOP, NULL);
-    if(cell.y() < MAZE_HEIGHT)this->mazeData[cell.x()][cell.y()+1].setWall(BOTTOM,NULL);
+    if(cell.y() < MAZE_HEIGHT-1)this->mazeData[cell.x()][cell.y()+1].setWall(BOTTOM,NULL);
+    this->commitEdit(cell);
     this->maze->drawMaze(this->mazeData);
 }
 
@@ -334,172 +346,197 @@ void microMouseServer::addBottomWall(QPoint cell)
 {
     this->mazeData[cell.x()][cell.y()].setWall(BOTTOM, NULL);
     if(cell.y() > 0)this->mazeData[cell.x()][cell.y()-1].setWall(TOP,NULL);
+    this->commitEdit(cell);
     this->maze->drawMaze(this->mazeData);
 }
 //--up to here
 
-void microMouseServer::startAI()
+void microMouseServer::syncMaze()
 {
-    QPoint newPos;
-    newPos.setX(1);
-    newPos.setY(1);
-    this->maze->drawMouse(newPos, dUP);
-    _aiCallTimer->start(MDELAY);
+    //hand the simulation a fresh copy of the walls, earlier snapshots keep the old one
+    const mazeLayout &rules = this->_sim.layout();
+    this->_sim.setLayout(mazeLayout::fromNodes(this->mazeData, &rules));
+    const mazeLayout &layout = this->_sim.layout();
+    this->maze->drawPath(*optimalSpeedRun(layout, this->_costs, layout.startX(), layout.startY(), layout.startDir()));
+    this->_stream.setMaze(layout);
+    this->_livePath.reset(this->_sim.layout());
+    this->drawLivePath();
 }
 
-void microMouseServer::foundFinish()
+void microMouseServer::commitEdit(QPoint cell)
 {
-    _aiCallTimer->stop();
-    ui->txt_status->append("Found end of maze.");
+    //only the clicked cell and its neighbours can change, each setWall updates the maze hash in O(1)
+    std::shared_ptr<mazeLayout> layout = std::make_shared<mazeLayout>(this->_sim.layout());
+    for(int d = -1; d < 4; d++)
+    {
+        int x = cell.x(), y = cell.y();
+        if(d >= 0)
+        {
+            x += stepX((mDirection)d);
+            y += stepY((mDirection)d);
+        }
+        if(layout->contains(x, y))
+        {
+            layout->setWalls(x, y, &this->mazeData[x][y]);
+            this->_livePath.cellChanged(*layout, x, y);
+        }
+    }
+    this->_sim.setLayout(layout);
+    this->_stream.setMaze(*layout);
+    this->maze->clearSweep();
+
+    //repair just the part of the distance field the edit touched, and replan the speed run so it does not go through the new wall
+    this->_livePath.repair(*layout);
+    this->drawLivePath();
+    this->maze->drawPath(*optimalSpeedRun(*layout, this->_costs, layout->startX(), layout->startY(), layout->startDir()));
 }
 
-void microMouseServer::printUI(const char *mesg)
+void microMouseServer::drawLivePath()
 {
-    ui->txt_status->append(mesg);
+    const mazeLayout &layout = this->_sim.layout();
+    this->maze->drawDistances(this->_livePath, this->_livePath.pathFrom(layout, layout.startX(), layout.startY()));
 }
 
-bool microMouseServer::isWallForward()
+void microMouseServer::drawMouse()
 {
-    baseMapNode *mover = &this->mazeData[this->maze->mouseX()-1][this->maze->mouseY()-1];
-    switch (this->maze->mouseDir()) {
-    case dUP:
-        return mover->isWallTop();
-        break;
-    case dDOWN:
-        return mover->isWallBottom();
-        break;
-    case dLEFT:
-        return mover->isWallLeft();
-        break;
-    case dRIGHT:
-        return mover->isWallRight();
-        break;
-    }
-
-    return true;
+    this->maze->drawMouse(QPoint(this->_sim.mouseX(), this->_sim.mouseY()), this->_sim.mouseDir());
+    this->_stream.mouseMoved(this->_sim);
 }
-bool microMouseServer::isWallLeft()
+
+runSummary microMouseServer::saveRunStats()
 {
-    baseMapNode *mover = &this->mazeData[this->maze->mouseX()-1][this->maze->mouseY()-1];
-    switch (this->maze->mouseDir()) {
-    case dUP:
-        return mover->isWallLeft();
-        break;
-    case dDOWN:
-        return mover->isWallRight();
-        break;
-    case dLEFT:
-        return mover->isWallBottom();
-        break;
-    case dRIGHT:
-        return mover->isWallTop();
-        break;
+    runSummary summary = this->_recorder.finish(this->_sim);
+    bool saved = appendRunCsv(STATS_RUNS_CSV, summary) &&
+                 appendRunColumns(STATS_RUNS_COL, summary) &&
+                 appendStepCsv(STATS_STEPS_CSV, summary.runId, this->_recorder.steps()) &&
+                 appendStepColumns(STATS_STEPS_COL, summary.runId, this->_recorder.steps());
+    const stepLog &steps = this->_recorder.steps();
+    if(steps.lost())
+    {
+        ui->txt_debug->append(QString("ERROR 206: %1 of %2 steps could not be kept in the temporary step log, %3 is missing them")
+                              .arg(steps.lost()).arg(steps.size()).arg(STATS_STEPS_CSV));
     }
-    return true;
+    else if(!saved)
+    {
+        ui->txt_debug->append("ERROR 206: could not write run statistics");
+    }
+    return summary;
 }
-bool microMouseServer::isWallRight()
+
+void microMouseServer::startAI()
 {
-    baseMapNode *mover = &this->mazeData[this->maze->mouseX()-1][this->maze->mouseY()-1];
-    switch (this->maze->mouseDir()) {
-    case dUP:
-        return mover->isWallRight();
-        break;
-    case dDOWN:
-        return mover->isWallLeft();
-        break;
-    case dLEFT:
-        return mover->isWallTop();
-        break;
-    case dRIGHT:
-        return mover->isWallBottom();
-        break;
+    //an unfinished run still gets its statistics saved
+    if(this->_recorder.isRunning())
+    {
+        this->saveRunStats();
+    }
+    const mazeLayout &layout = this->_sim.layout();
+    this->_sim.reset(layout.startX(), layout.startY(), layout.startDir());
+    this->_recorder.begin(this->_sim, this->_mazeName.toStdString(), "studentAI");
+    this->showDroppedPrints();
+    this->_printLimit.reset();
+    this->maze->clearSweep();
+    this->_ai.attach(&this->_sim, &this->_recorder, this);
+    this->maze->setFog(&this->_sim);
+    if(!this->maze->isLargeMaze())
+    {
+        this->maze->drawPath(*optimalSpeedRun(layout, this->_costs, layout.startX(), layout.startY(), layout.startDir()));
     }
-    return true;
+    this->drawMouse();
+    _aiCallTimer->start(MDELAY);
 }
-bool microMouseServer::moveForward()
+
+void microMouseServer::runAI()
 {
-    bool hasMoved = false;
-    QPoint newPos;
-    newPos.setX(this->maze->mouseX());
-    newPos.setY(this->maze->mouseY());
-    baseMapNode *mover = &this->mazeData[this->maze->mouseX()-1][this->maze->mouseY()-1];
-    switch (this->maze->mouseDir()) {
-    case dUP:
-        if(!mover->isWallTop())
-        {
-            newPos.setY(newPos.y()+1);
-            this->maze->drawMouse(newPos, dUP);
-            hasMoved = true;
-        }
-        break;
-    case dDOWN:
-        if(!mover->isWallBottom())
-        {
-            newPos.setY(newPos.y()-1);
-            this->maze->drawMouse(newPos, dDOWN);
-            hasMoved = true;
-        }
-        break;
-    case dLEFT:
-        if(!mover->isWallLeft())
-        {
-            newPos.setX(newPos.x()-1);
-            this->maze->drawMouse(newPos, dLEFT);
-            hasMoved = true;
-        }
-        break;
-    case dRIGHT:
-        if(!mover->isWallRight())
-        {
-            newPos.setX(newPos.x()+1);
-            this->maze->drawMouse(newPos, dRIGHT);
-            hasMoved = true;
-        }
-        break;
+    this->_ai.step();
+    this->maze->updateFog();
+}
+
+void microMouseServer::sweepAI()
+{
+    if(this->maze->isLargeMaze())
+    {
+        ui->txt_debug->append("ERROR 209: start pose sweeps only run on mazes the editor can hold");
+        return;
     }
 
-    return hasMoved;
+    //every start pose gets its own studentMouse, on as many threads as there are cores and off the event loop
+    std::shared_ptr<const mazeLayout> layout = this->_sim.layoutPtr();
+    this->_sweepLayout = layout;
+    this->_sweepClock.start();
+    ui->menu_sweep->setEnabled(false);
+    ui->txt_status->append("Sweep started");
+    if(studentMouse().stateHash() == AI_STATE_UNKNOWN)
+    {
+        ui->txt_status->append("studentMouse::stateHash() is not written, start poses that loop run until they time out");
+    }
+    this->_sweepWatcher->setFuture(QtConcurrent::run([layout]()
+    {
+        return sweepStarts(layout, []() { return new studentMouse; }, SWEEP_MAX_TICKS);
+    }));
 }
-void microMouseServer::turnLeft()
+
+void microMouseServer::sweepDone()
 {
-    QPoint newPos;
-    newPos.setX(this->maze->mouseX());
-    newPos.setY(this->maze->mouseY());
-    switch(this->maze->mouseDir()){
-    case dUP:
-        this->maze->drawMouse(newPos, dLEFT);
-        break;
-    case dDOWN:
-        this->maze->drawMouse(newPos, dRIGHT);
-        break;
-    case dLEFT:
-        this->maze->drawMouse(newPos, dDOWN);
-        break;
-    case dRIGHT:
-        this->maze->drawMouse(newPos, dUP);
-        break;
+    ui->menu_sweep->setEnabled(true);
+    sweepMap map = this->_sweepWatcher->result();
+    if(this->_sweepLayout != this->_sim.layoutPtr())
+    {
+        ui->txt_status->append("Sweep finished, but the maze changed while it ran so it is not shown");
+        return;
     }
+    this->maze->drawSweep(map);
+    ui->txt_status->append(QString("Sweep: %1 of %2 start poses reach the goal, %3 loop, %4 time out, %5 finish outside the goal (%6 ms)")
+                           .arg(map.count(oGOAL)).arg(map.runs()).arg(map.count(oLOOP)).arg(map.count(oTIMEOUT))
+                           .arg(map.count(oFALSE_FINISH)).arg(this->_sweepClock.elapsed()));
+}
 
+void microMouseServer::mouseMoved(const simState &)
+{
+    this->drawMouse();
 }
-void microMouseServer::turnRight()
+
+void microMouseServer::printed(const simState &, const char *mesg)
 {
-    QPoint newPos;
-    newPos.setX(this->maze->mouseX());
-    newPos.setY(this->maze->mouseY());
-    switch(this->maze->mouseDir()){
-    case dUP:
-        this->maze->drawMouse(newPos, dRIGHT);
-        break;
-    case dDOWN:
-        this->maze->drawMouse(newPos, dLEFT);
-        break;
-    case dLEFT:
-        this->maze->drawMouse(newPos, dUP);
-        break;
-    case dRIGHT:
-        this->maze->drawMouse(newPos, dDOWN);
-        break;
+    //spectators get everything, their stream has its own limit
+    this->_stream.printed(this->_sim, mesg);
+    if(this->_printLimit.admit())
+    {
+        this->showDroppedPrints();
+        ui->txt_status->append(mesg);
+    }
+    else if(!this->_printTimer->isActive())
+    {
+        //an AI that stops printing, or never gets another message through, still has its count shown
+        this->_printTimer->start(_printFlushMs);
     }
 }
 
+void microMouseServer::showDroppedPrints()
+{
+    this->_printTimer->stop();
+    long dropped = this->_printLimit.takeDropped();
+    if(dropped)
+    {
+        ui->txt_status->append(QString("(%1 printUI() messages not shown)").arg(dropped));
+    }
+}
 
+void microMouseServer::finished(const simState &state)
+{
+    _aiCallTimer->stop();
+    this->_stream.finished(state);
+    this->showDroppedPrints();
+    runSummary summary = this->saveRunStats();
+    if(!state.mouse().atGoal)
+    {
+        ui->txt_status->append(QString("foundFinish() called at (%1, %2), which is not in the goal. Run failed.")
+                               .arg(state.mouseX()).arg(state.mouseY()));
+        return;
+    }
+    ui->txt_status->append("Found end of maze.");
+    ui->txt_status->append(QString("Run time: %1 s").arg(summary.motionTimeS, 0, 'f', 2));
+    ui->txt_status->append(QString("Speed run cost: %1 explored, %2 optimal").arg(summary.speedRunCost).arg(summary.optimalSpeedRunCost));
+    ui->txt_status->append(QString("Explored %1% of the maze, %2 of %3 sensor calls were repeats")
+                           .arg(100*summary.sensedFraction, 0, 'f', 1).arg(summary.redundantSensors).arg(summary.sensorCalls));
+}
@@ -3,6 +3,10 @@
 #include "mazeConst.h"
 #include "mazeBase.h"
 #include "mazegui.h"
+#include "mazeState.h"
+#include "runStats.h"
+#include "spectator.h"
+#include "studentai.h"
 #include <QMainWindow>
 #include <QGraphicsScene>
 #include <QGraphicsView>
@@ -11,19 +15,23 @@
 #include <QGraphicsSceneMouseEvent>
 #include <QLineF>
 #include <QTimer>
+#include <QElapsedTimer>
+#include <QFutureWatcher>
 
 
 
+struct mazeFileContents;
+
 namespace Ui {
 class microMouseServer;
 }
 
-class microMouseServer : public QMainWindow
+class microMouseServer : public QMainWindow, public aiListener
 {
     Q_OBJECT
 
 public:
-    explicit microMouseServer(QWidget *parent = 0);
+    explicit microMouseServer(QWidget *parent = 0, const QString &spectatePath = SPECTATOR_PATH);
     ~microMouseServer();
 
 private slots:
@@ -41,28 +49,48 @@ private slots:
     void netComs();
     void connect2mouse();
     void startAI();
-    void studentAI();
+    void runAI();
+    void sweepAI();
+    void sweepDone();
+    void showDroppedPrints();
 
 
 private:
-    bool isWallLeft();
-    bool isWallRight();
-    bool isWallForward();
-    bool moveForward();
-    void turnLeft();
-    void turnRight();
-    void foundFinish();
-    void printUI(const char *mesg);
+    void mouseMoved(const simState &state);
+    void printed(const simState &state, const char *mesg);
+    void finished(const simState &state);
 
     QTimer *_comTimer;
     QTimer *_aiCallTimer;
+    QTimer *_printTimer;
+    QFutureWatcher<sweepMap> *_sweepWatcher;
+    QElapsedTimer _sweepClock;
+    std::shared_ptr<const mazeLayout> _sweepLayout;
     static const int _mDelay = 100;
+    static const int _lintShown = 10;
+    static const int _statusLines = 5000;
+    static const int _printFlushMs = 1000;
     Ui::microMouseServer *ui;
     mazeGui *maze;
     std::vector<QGraphicsLineItem*> backgroundGrid;
     struct baseMapNode mazeData[MAZE_WIDTH][MAZE_HEIGHT];
+    simState _sim;
+    studentMouse _ai;
+    runRecorder _recorder;
+    printLimiter _printLimit;
+    motionScorer _scorer;
+    plannerCosts _costs;
+    dynamicPath _livePath;
+    QString _mazeName;
+    spectatorStream _stream;
     void connectSignals();
     void initMaze();
+    void syncMaze();
+    void commitEdit(QPoint cell);
+    void drawLivePath();
+    void drawMouse();
+    void lintLoaded(const QString &fileName, const mazeFileContents &contents);
+    runSummary saveRunStats();
 };
 
 #endif // MICROMOUSESERVER_H
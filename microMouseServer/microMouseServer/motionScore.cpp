@@ -0,0 +1,69 @@
+#include "motionScore.h"
+#include <cmath>
+
+motionConfig::motionConfig() :
+    cellSize(0.18),
+    maxSpeed(2.0),
+    accel(4.0),
+    turnPenalty(0.25)
+{
+}
+
+motionScorer::motionScorer(const motionConfig &config, int longestStraight) :
+    _config(config)
+{
+    _segmentCache.reserve(longestStraight + 1);
+    for(int n = 0; n <= longestStraight; n++)
+    {
+        _segmentCache.push_back(segmentTime(n));
+    }
+}
+
+double motionScorer::segmentTime(int cells) const
+{
+    if(cells <= 0)
+    {
+        return 0;
+    }
+    double v = _config.maxSpeed, a = _config.accel;
+    double dist = cells * _config.cellSize;
+    if(dist >= v*v / a)
+    {
+        //reaches top speed, the ramps up and down cost v/a over cruising
+        return dist / v + v / a;
+    }
+    //never reaches top speed, triangular profile
+    return 2 * std::sqrt(dist / a);
+}
+
+motionTimer::motionTimer(const motionScorer *scorer) :
+    _scorer(scorer),
+    _straight(0),
+    _total(0)
+{
+}
+
+void motionTimer::turn()
+{
+    if(!_scorer)
+    {
+        return;
+    }
+    _total += _scorer->straightTime(_straight) + _scorer->turnTime();
+    _straight = 0;
+}
+
+double motionTimer::total() const
+{
+    if(!_scorer)
+    {
+        return -1;
+    }
+    return _total + _scorer->straightTime(_straight);
+}
+
+void motionTimer::reset()
+{
+    _straight = 0;
+    _total = 0;
+}
@@ -0,0 +1,57 @@
+#ifndef MOTION_SCORE_H
+#define MOTION_SCORE_H
+
+#include "mazeConst.h"
+#include <vector>
+
+//physical model used to turn a run into seconds, defaults are a typical classic mouse
+struct motionConfig
+{
+    double cellSize;     //metres per cell
+    double maxSpeed;     //metres per second
+    double accel;        //metres per second squared, also used to brake
+    double turnPenalty;  //seconds per 90 degree turn in place
+
+    motionConfig();
+};
+
+/*
+ * Times straight segments with a trapezoidal speed profile that starts and
+ * ends at rest, so one long straight beats the same cells split by turns.
+ * Segment times only depend on their length, they are cached up front for
+ * every length that fits in the maze so one scorer can be shared by threads.
+ */
+class motionScorer
+{
+public:
+    explicit motionScorer(const motionConfig &config = motionConfig(), int longestStraight = MAZE_WIDTH > MAZE_HEIGHT ? MAZE_WIDTH : MAZE_HEIGHT);
+
+    const motionConfig &config() const { return _config; }
+    double straightTime(int cells) const { return cells < (int)_segmentCache.size() ? _segmentCache[cells] : segmentTime(cells); }
+    double turnTime() const { return _config.turnPenalty; }
+
+private:
+    double segmentTime(int cells) const;
+
+    motionConfig _config;
+    std::vector<double> _segmentCache;
+};
+
+//running total for one run, fed one action at a time
+class motionTimer
+{
+public:
+    explicit motionTimer(const motionScorer *scorer = 0);
+
+    void forward() { _straight++; }
+    void turn();
+    double total() const;
+    void reset();
+
+private:
+    const motionScorer *_scorer;
+    int _straight;
+    double _total;
+};
+
+#endif
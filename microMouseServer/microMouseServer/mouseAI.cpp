@@ -0,0 +1,112 @@
+#include "mouseAI.h"
+
+mouseAI::mouseAI() :
+    _sim(0),
+    _recorder(0),
+    _listener(0)
+{
+}
+
+mouseAI::~mouseAI()
+{
+}
+
+void mouseAI::attach(simState *state, runRecorder *recorder, aiListener *listener)
+{
+    _sim = state;
+    _recorder = recorder;
+    _listener = listener;
+}
+
+void mouseAI::step()
+{
+    if(!_sim || _sim->isFinished())
+    {
+        return;
+    }
+    _sim->tick();
+    studentAI();
+}
+
+void mouseAI::record(stepAction action)
+{
+    if(_recorder)
+    {
+        _recorder->record(*_sim, action);
+    }
+}
+
+bool mouseAI::isWallLeft()
+{
+    return _sim->isWallLeft();
+}
+
+bool mouseAI::isWallRight()
+{
+    return _sim->isWallRight();
+}
+
+bool mouseAI::isWallForward()
+{
+    return _sim->isWallForward();
+}
+
+bool mouseAI::moveForward()
+{
+    long revisits = _sim->mouse().revisits;
+    bool hasMoved = _sim->moveForward();
+    if(!hasMoved)
+    {
+        record(aBLOCKED);
+        return false;
+    }
+    record(_sim->mouse().revisits > revisits ? aREVISIT : aFORWARD);
+    if(_listener)
+    {
+        _listener->mouseMoved(*_sim);
+    }
+    return true;
+}
+
+void mouseAI::turnLeft()
+{
+    _sim->turnLeft();
+    record(aLEFT);
+    if(_listener)
+    {
+        _listener->mouseMoved(*_sim);
+    }
+}
+
+void mouseAI::turnRight()
+{
+    _sim->turnRight();
+    record(aRIGHT);
+    if(_listener)
+    {
+        _listener->mouseMoved(*_sim);
+    }
+}
+
+void mouseAI::foundFinish()
+{
+    if(_sim->isFinished())
+    {
+        return;
+    }
+    _sim->finish();
+    record(aFINISH);
+    if(_listener)
+    {
+        _listener->finished(*_sim);
+    }
+}
+
+void mouseAI::printUI(const char *mesg)
+{
+    record(aPRINT);
+    if(_listener)
+    {
+        _listener->printed(*_sim, mesg);
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef MOUSE_AI_H
+#define MOUSE_AI_H
+
+#include "mazeState.h"
+#include "runStats.h"
+
+//stateHash() of an AI that has not said what it remembers between calls
+#define AI_STATE_UNKNOWN 0xFFFFFFFFFFFFFFFFULL
+
+//told about everything an AI does, the gui redraws from here and the cli prints
+class aiListener
+{
+public:
+    virtual ~aiListener() {}
+    virtual void mouseMoved(const simState &) {}
+    virtual void printed(const simState &, const char *) {}
+    virtual void finished(const simState &) {}
+};
+
+/*
+ * Base class for every maze solving AI. studentAI() is called once per tick
+ * and may only use the eight protected functions below, which act on the
+ * attached simState and report to the recorder and listener.
+ */
+class mouseAI
+{
+public:
+    mouseAI();
+    virtual ~mouseAI();
+
+    void attach(simState *state, runRecorder *recorder = 0, aiListener *listener = 0);
+    void step();
+    virtual void studentAI() = 0;
+    //called before every run of a competition session, 0 is the search run
+    virtual void runStarted(int) {}
+    /*
+     * Hash of everything the AI remembers between calls to studentAI(), 0 if
+     * it remembers nothing. The same cell, heading and state hash twice in a
+     * run means the mouse is in a loop. Left as AI_STATE_UNKNOWN loops are
+     * never reported and such runs go on until they time out.
+     */
+    virtual unsigned long long stateHash() const { return AI_STATE_UNKNOWN; }
+
+protected:
+    bool isWallLeft();
+    bool isWallRight();
+    bool isWallForward();
+    bool moveForward();
+    void turnLeft();
+    void turnRight();
+    void foundFinish();
+    void printUI(const char *mesg);
+
+private:
+    void record(stepAction action);
+
+    simState *_sim;
+    runRecorder *_recorder;
+    aiListener *_listener;
+};
+
+#endif
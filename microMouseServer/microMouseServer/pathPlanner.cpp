@@ -0,0 +1,187 @@
+#include "pathPlanner.h"
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <unordered_map>
+
+#define PLAN_CACHE_SIZE 256
+
+//headings clockwise from east, even ones line up with mDirection
+static const int headX[8] = {1, 1, 0, -1, -1, -1, 0, 1};
+static const int headY[8] = {0, -1, -1, -1, 0, 1, 1, 1};
+
+plannerCosts::plannerCosts() :
+    straight(1.0),
+    diagonal(1.41421356),
+    turn45(0.5),
+    turn90(1.0),
+    diagonals(true)
+{
+}
+
+unsigned long long plannerCosts::hash() const
+{
+    double vals[4] = {straight, diagonal, turn45, turn90};
+    unsigned long long hash = diagonals ? 1 : 2;
+    for(int i = 0; i < 4; i++)
+    {
+        unsigned long long raw;
+        memcpy(&raw, &vals[i], sizeof(raw));
+        hash = (hash ^ raw) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+static bool usable(const mazeLayout &layout, const knownMap *known, int x, int y)
+{
+    return layout.contains(x, y) && (!known || known->isVisited(x, y));
+}
+
+//can the mouse get from (x,y) to the next cell along heading without hitting a wall
+static bool canMove(const mazeLayout &layout, const knownMap *known, int x, int y, int heading)
+{
+    int nx = x + headX[heading], ny = y + headY[heading];
+    if(!usable(layout, known, nx, ny))
+    {
+        return false;
+    }
+    if(heading % 2 == 0)
+    {
+        return !layout.isWall(x, y, (mDirection)(heading / 2));
+    }
+
+    //a diagonal passes through one of the two side cells, either will do
+    mDirection a = (mDirection)(((heading + 7) % 8) / 2);
+    mDirection b = (mDirection)(((heading + 1) % 8) / 2);
+    int ax = x + stepX(a), ay = y + stepY(a);
+    int bx = x + stepX(b), by = y + stepY(b);
+    bool viaA = usable(layout, known, ax, ay) && !layout.isWall(x, y, a) && !layout.isWall(ax, ay, b);
+    bool viaB = usable(layout, known, bx, by) && !layout.isWall(x, y, b) && !layout.isWall(bx, by, a);
+    return viaA || viaB;
+}
+
+plannedPath planSpeedRun(const mazeLayout &layout, const plannerCosts &costs,
+                         int startX, int startY, mDirection startDir, const knownMap *known)
+{
+    plannedPath path;
+    int sx = startX - 1, sy = startY - 1;
+    if(!usable(layout, 0, sx, sy))
+    {
+        return path;
+    }
+
+    //only states the search reaches are stored, a plan over what the mouse visited stays small on any maze
+    struct searchNode
+    {
+        double dist;
+        int parent;
+    };
+    std::unordered_map<int, searchNode> seen;
+    typedef std::pair<double, int> entry;
+    std::priority_queue<entry, std::vector<entry>, std::greater<entry> > open;
+
+    int start = (sy*layout.width() + sx)*8 + startDir*2;
+    seen[start] = searchNode{0, -1};
+    open.push(entry(0, start));
+    int goal = -1;
+    while(!open.empty())
+    {
+        entry top = open.top();
+        open.pop();
+        int state = top.second;
+        if(top.first > seen[state].dist)
+        {
+            continue;
+        }
+        int cell = state / 8, heading = state % 8;
+        int x = cell % layout.width(), y = cell / layout.width();
+        if(layout.isGoal(x, y))
+        {
+            goal = state;
+            break;
+        }
+
+        //every way out of this state as (next state, cost)
+        entry next[5];
+        int count = 0;
+        if(canMove(layout, known, x, y, heading))
+        {
+            int ncell = (y + headY[heading])*layout.width() + x + headX[heading];
+            next[count++] = entry(heading % 2 ? costs.diagonal : costs.straight, ncell*8 + heading);
+        }
+        next[count++] = entry(costs.turn90, cell*8 + (heading + 2) % 8);
+        next[count++] = entry(costs.turn90, cell*8 + (heading + 6) % 8);
+        if(costs.diagonals)
+        {
+            next[count++] = entry(costs.turn45, cell*8 + (heading + 1) % 8);
+            next[count++] = entry(costs.turn45, cell*8 + (heading + 7) % 8);
+        }
+        for(int i = 0; i < count; i++)
+        {
+            double cost = top.first + next[i].first;
+            int to = next[i].second;
+            std::pair<std::unordered_map<int, searchNode>::iterator, bool> found = seen.insert(std::make_pair(to, searchNode{cost, state}));
+            if(found.second || cost < found.first->second.dist)
+            {
+                found.first->second = searchNode{cost, state};
+                open.push(entry(cost, to));
+            }
+        }
+    }
+
+    if(goal < 0)
+    {
+        return path;
+    }
+    path.cost = seen[goal].dist;
+    for(int state = goal; state >= 0; state = seen[state].parent)
+    {
+        pathStep step;
+        step.x = (state / 8) % layout.width() + 1;
+        step.y = (state / 8) / layout.width() + 1;
+        step.heading = state % 8;
+        //turning in place shows up as repeated cells, keep the heading each cell was entered with
+        if(!path.steps.empty() && path.steps.back().x == step.x && path.steps.back().y == step.y)
+        {
+            path.steps.back() = step;
+        }
+        else
+        {
+            path.steps.push_back(step);
+        }
+    }
+    std::reverse(path.steps.begin(), path.steps.end());
+    return path;
+}
+
+std::shared_ptr<const plannedPath> optimalSpeedRun(const mazeLayout &layout, const plannerCosts &costs,
+                                                   int startX, int startY, mDirection startDir)
+{
+    static std::mutex lock;
+    static std::map<unsigned long long, std::shared_ptr<const plannedPath> > cache;
+
+    unsigned long long key = layout.hash();
+    key = (key ^ costs.hash()) * 1099511628211ULL;
+    key = (key ^ (unsigned long long)(startX*4096*4 + startY*4 + startDir)) * 1099511628211ULL;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        std::map<unsigned long long, std::shared_ptr<const plannedPath> >::iterator found = cache.find(key);
+        if(found != cache.end())
+        {
+            return found->second;
+        }
+    }
+
+    //plan outside the lock, two threads racing on the same maze just both plan it
+    std::shared_ptr<const plannedPath> path = std::make_shared<plannedPath>(planSpeedRun(layout, costs, startX, startY, startDir));
+    std::lock_guard<std::mutex> guard(lock);
+    if(cache.size() >= PLAN_CACHE_SIZE)
+    {
+        cache.clear();
+    }
+    cache[key] = path;
+    return path;
+}
@@ -0,0 +1,52 @@
+#ifndef PATH_PLANNER_H
+#define PATH_PLANNER_H
+
+#include "mazeState.h"
+#include <memory>
+#include <vector>
+
+//mazes with more cells than this get no optimal speed run in the run statistics, planning one would take seconds
+#define PLAN_MAX_CELLS (1024*1024)
+
+//relative costs of a speed run, units only matter against each other
+struct plannerCosts
+{
+    double straight;    //one cell along a corridor
+    double diagonal;    //one cell diagonally, crossing a post corner, sqrt(2) straights long
+    double turn45;
+    double turn90;
+    bool diagonals;
+
+    plannerCosts();
+    unsigned long long hash() const;
+};
+
+//one cell of a planned path, heading counts in 45 degree steps with 2*mDirection for the square ones
+struct pathStep
+{
+    int x, y;
+    int heading;
+};
+
+struct plannedPath
+{
+    double cost;
+    std::vector<pathStep> steps;
+
+    plannedPath() : cost(-1) {}
+    bool found() const { return cost >= 0; }
+};
+
+/*
+ * Dijkstra over (cell, heading) from the start pose to any goal cell. When
+ * known is given only cells the mouse visited can be used, which gives the
+ * best speed run the mouse could have planned from its own exploration.
+ */
+plannedPath planSpeedRun(const mazeLayout &layout, const plannerCosts &costs,
+                         int startX, int startY, mDirection startDir, const knownMap *known = 0);
+
+//same as planSpeedRun on the full maze but cached by maze content, safe to call from any thread
+std::shared_ptr<const plannedPath> optimalSpeedRun(const mazeLayout &layout, const plannerCosts &costs,
+                                                   int startX = 1, int startY = 1, mDirection startDir = dUP);
+
+#endif
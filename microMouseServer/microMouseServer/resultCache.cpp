@@ -0,0 +1,221 @@
+#include "resultCache.h"
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+#define CACHE_MAGIC "MRC3"
+
+//fixed size image of one cache entry, names are not kept
+struct cacheRecord
+{
+    unsigned long long mazeHash, aiHash, configHash;
+    int startX, startY, startDir;
+    int finished;
+    long long ticks, steps, turns, revisits, prints;
+    long long sensorCalls, redundantSensors;
+    double sensedFraction;
+    int optimalLength;
+    int pad;
+    double timeToGoalMs, motionTimeS, speedRunCost, optimalSpeedRunCost;
+};
+
+cacheKey::cacheKey() :
+    mazeHash(0),
+    aiHash(0),
+    configHash(0),
+    startX(1),
+    startY(1),
+    startDir(dUP)
+{
+}
+
+bool cacheKey::operator==(const cacheKey &other) const
+{
+    return mazeHash == other.mazeHash && aiHash == other.aiHash && configHash == other.configHash &&
+           startX == other.startX && startY == other.startY && startDir == other.startDir;
+}
+
+size_t cacheKeyHash::operator()(const cacheKey &key) const
+{
+    unsigned long long hash = mixHash(key.mazeHash ^ mixHash(key.aiHash ^ mixHash(key.configHash)));
+    return (size_t)mixHash(hash ^ ((unsigned long long)key.startX << 32) ^ ((unsigned long long)key.startY << 2) ^ key.startDir);
+}
+
+bool aiHash(const std::string &binaryPath, const std::string &aiName, unsigned long long &hash)
+{
+    //FNV-1a over the name then the binary, eight bytes at a time
+    hash = 14695981039346656037ULL;
+    for(size_t i = 0; i < aiName.size(); i++)
+    {
+        hash = (hash ^ (unsigned char)aiName[i]) * 1099511628211ULL;
+    }
+    FILE *file = fopen(binaryPath.c_str(), "rb");
+    if(!file)
+    {
+        return false;
+    }
+    unsigned long long buf[4096];
+    size_t got;
+    while((got = fread(buf, 1, sizeof(buf), file)) > 0)
+    {
+        //a short last read leaves stale bytes in its last word, zero them so the hash only sees the file
+        size_t tail = (8 - got % 8) % 8;
+        memset((char *)buf + got, 0, tail);
+        for(size_t i = 0; i < (got + 7) / 8; i++)
+        {
+            hash = (hash ^ buf[i]) * 1099511628211ULL;
+        }
+    }
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+unsigned long long configHash(const motionConfig &motion, const plannerCosts &costs, long maxTicks, bool stopAtGoal)
+{
+    double vals[4] = {motion.cellSize, motion.maxSpeed, motion.accel, motion.turnPenalty};
+    unsigned long long hash = mixHash(costs.hash() ^ (unsigned long long)maxTicks);
+    hash = mixHash(hash ^ (stopAtGoal ? 1 : 2));
+    for(int i = 0; i < 4; i++)
+    {
+        unsigned long long raw;
+        memcpy(&raw, &vals[i], sizeof(raw));
+        hash = mixHash(hash ^ raw);
+    }
+    return hash;
+}
+
+resultCache::resultCache() :
+    _file(0)
+{
+}
+
+resultCache::~resultCache()
+{
+    if(_file)
+    {
+        fclose(_file);
+    }
+}
+
+bool resultCache::open(const std::string &path)
+{
+    if(_file)
+    {
+        fclose(_file);
+        _results.clear();
+    }
+    _file = fopen(path.c_str(), "a+b");
+    if(!_file)
+    {
+        return false;
+    }
+
+    fseek(_file, 0, SEEK_SET);
+    char magic[4];
+    size_t got = fread(magic, 1, 4, _file);
+    //another version's keys do not match ours, its results are dropped
+    bool stale = got == 4 && memcmp(magic, CACHE_MAGIC, 3) == 0 && magic[3] != CACHE_MAGIC[3];
+    if(!stale && memcmp(magic, CACHE_MAGIC, got) != 0)
+    {
+        fclose(_file);
+        _file = 0;
+        return false;
+    }
+
+    cacheRecord rec;
+    long valid = got == 4 && !stale ? 4 : 0;
+    while(valid && fread(&rec, sizeof(rec), 1, _file) == 1)
+    {
+        cacheKey key;
+        key.mazeHash = rec.mazeHash;
+        key.aiHash = rec.aiHash;
+        key.configHash = rec.configHash;
+        key.startX = rec.startX;
+        key.startY = rec.startY;
+        key.startDir = rec.startDir;
+        runSummary summary;
+        summary.finished = rec.finished != 0;
+        summary.ticks = rec.ticks;
+        summary.steps = rec.steps;
+        summary.turns = rec.turns;
+        summary.revisits = rec.revisits;
+        summary.prints = rec.prints;
+        summary.sensorCalls = rec.sensorCalls;
+        summary.redundantSensors = rec.redundantSensors;
+        summary.sensedFraction = rec.sensedFraction;
+        summary.optimalLength = rec.optimalLength;
+        summary.timeToGoalMs = rec.timeToGoalMs;
+        summary.motionTimeS = rec.motionTimeS;
+        summary.speedRunCost = rec.speedRunCost;
+        summary.optimalSpeedRunCost = rec.optimalSpeedRunCost;
+        _results[key] = summary;
+        valid += sizeof(rec);
+    }
+
+    //a killed run can leave a torn record or magic, cut it off or everything appended after it is misaligned
+    fseek(_file, 0, SEEK_END);
+    if(ftell(_file) != valid)
+    {
+        fclose(_file);
+        std::error_code err;
+        std::filesystem::resize_file(path, valid, err);
+        _file = err ? 0 : fopen(path.c_str(), "a+b");
+        if(!_file)
+        {
+            _results.clear();
+            return false;
+        }
+    }
+    if(!valid)
+    {
+        fwrite(CACHE_MAGIC, 1, 4, _file);
+        fflush(_file);
+    }
+    return true;
+}
+
+bool resultCache::find(const cacheKey &key, runSummary &summary) const
+{
+    std::unordered_map<cacheKey, runSummary, cacheKeyHash>::const_iterator found = _results.find(key);
+    if(found == _results.end())
+    {
+        return false;
+    }
+    summary = found->second;
+    return true;
+}
+
+bool resultCache::store(const cacheKey &key, const runSummary &summary)
+{
+    _results[key] = summary;
+    if(!_file)
+    {
+        return false;
+    }
+    cacheRecord rec;
+    memset(&rec, 0, sizeof(rec));
+    rec.mazeHash = key.mazeHash;
+    rec.aiHash = key.aiHash;
+    rec.configHash = key.configHash;
+    rec.startX = key.startX;
+    rec.startY = key.startY;
+    rec.startDir = key.startDir;
+    rec.finished = summary.finished;
+    rec.ticks = summary.ticks;
+    rec.steps = summary.steps;
+    rec.turns = summary.turns;
+    rec.revisits = summary.revisits;
+    rec.prints = summary.prints;
+    rec.sensorCalls = summary.sensorCalls;
+    rec.redundantSensors = summary.redundantSensors;
+    rec.sensedFraction = summary.sensedFraction;
+    rec.optimalLength = summary.optimalLength;
+    rec.timeToGoalMs = summary.timeToGoalMs;
+    rec.motionTimeS = summary.motionTimeS;
+    rec.speedRunCost = summary.speedRunCost;
+    rec.optimalSpeedRunCost = summary.optimalSpeedRunCost;
+    bool ok = fwrite(&rec, sizeof(rec), 1, _file) == 1;
+    fflush(_file);
+    return ok;
+}
@@ -0,0 +1,52 @@
+#ifndef RESULTCACHE_H
+#define RESULTCACHE_H
+
+#include "runStats.h"
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+
+//everything that decides the outcome of a deterministic run
+struct cacheKey
+{
+    unsigned long long mazeHash;
+    unsigned long long aiHash;
+    unsigned long long configHash;
+    int startX, startY;
+    int startDir;
+
+    cacheKey();
+    bool operator==(const cacheKey &other) const;
+};
+
+struct cacheKeyHash
+{
+    size_t operator()(const cacheKey &key) const;
+};
+
+//hash of the file an AI was compiled into together with its name, false if the file can not be read
+bool aiHash(const std::string &binaryPath, const std::string &aiName, unsigned long long &hash);
+unsigned long long configHash(const motionConfig &motion, const plannerCosts &costs, long maxTicks, bool stopAtGoal);
+
+/*
+ * On disk cache of finished runs. The file is a list of fixed size records
+ * that is read into memory once and appended to as new results come in, so
+ * a lookup never touches the disk.
+ */
+class resultCache
+{
+public:
+    resultCache();
+    ~resultCache();
+
+    bool open(const std::string &path);
+    bool find(const cacheKey &key, runSummary &summary) const;
+    bool store(const cacheKey &key, const runSummary &summary);
+    size_t size() const { return _results.size(); }
+
+private:
+    FILE *_file;
+    std::unordered_map<cacheKey, runSummary, cacheKeyHash> _results;
+};
+
+#endif // RESULTCACHE_H
@@ -0,0 +1,220 @@
+#include "runLog.h"
+#include "lzBlock.h"
+#include <cmath>
+#include <cstring>
+
+//bytes per step once unpacked, see the column list in runLog.h
+#define STEP_BYTES 14
+#define CHUNK_HEAD 28
+
+static void putLE(unsigned char *at, unsigned long long val, int bytes)
+{
+    for(int i = 0; i < bytes; i++)
+    {
+        at[i] = (unsigned char)(val >> (8*i));
+    }
+}
+
+static unsigned long long getLE(const unsigned char *at, int bytes)
+{
+    unsigned long long val = 0;
+    for(int i = bytes-1; i >= 0; i--)
+    {
+        val = (val << 8) | at[i];
+    }
+    return val;
+}
+
+static long long toMicros(double ms)
+{
+    return (long long)llround(ms * 1000.0);
+}
+
+stepLog::stepLog(size_t recent, size_t chunk) :
+    _ring(recent < chunk ? chunk : recent),
+    _chunk(chunk),
+    _total(0),
+    _saved(0),
+    _lost(0),
+    _file(NULL)
+{
+}
+
+stepLog::~stepLog()
+{
+    if(_file)
+    {
+        fclose(_file);
+    }
+}
+
+void stepLog::clear()
+{
+    //a fresh file each run, the old one is deleted when it is closed
+    if(_file)
+    {
+        fclose(_file);
+        _file = NULL;
+    }
+    _total = _saved = _lost = 0;
+}
+
+void stepLog::push(const stepRecord &rec)
+{
+    //the ring is at least a chunk long, so nothing unsaved is ever overwritten
+    _ring[_total % _ring.size()] = rec;
+    _total++;
+    if(_total - _saved >= (long long)_chunk)
+    {
+        spill();
+    }
+}
+
+void stepLog::spill()
+{
+    size_t rows = _chunk;
+    _raw.resize(CHUNK_HEAD + rows*STEP_BYTES);
+    unsigned char *cols = &_raw[CHUNK_HEAD];
+    const stepRecord &first = _ring[_saved % _ring.size()];
+    long long lastTick = first.tick, lastUs = toMicros(first.timeMs);
+    for(size_t i = 0; i < rows; i++)
+    {
+        const stepRecord &rec = _ring[(_saved + i) % _ring.size()];
+        long long us = toMicros(rec.timeMs);
+        putLE(cols + 4*i, (unsigned long long)(rec.tick - lastTick), 4);
+        putLE(cols + 4*rows + 4*i, (unsigned long long)(us - lastUs), 4);
+        putLE(cols + 8*rows + 2*i, (unsigned long long)rec.x, 2);
+        putLE(cols + 10*rows + 2*i, (unsigned long long)rec.y, 2);
+        cols[12*rows + i] = (unsigned char)rec.dir;
+        cols[13*rows + i] = (unsigned char)rec.action;
+        lastTick = rec.tick;
+        lastUs = us;
+    }
+    lzCompress(cols, rows*STEP_BYTES, _packed);
+
+    memcpy(&_raw[0], "MSTP", 4);
+    putLE(&_raw[4], rows, 4);
+    putLE(&_raw[8], _packed.size(), 4);
+    putLE(&_raw[12], (unsigned long long)first.tick, 8);
+    putLE(&_raw[20], (unsigned long long)toMicros(first.timeMs), 8);
+
+    //tmpfile() goes away by itself when it is closed, even if the program is killed
+    if(!_file && !_lost)
+    {
+        _file = tmpfile();
+    }
+    if(!_file || _lost || fwrite(&_raw[0], 1, CHUNK_HEAD, _file) != CHUNK_HEAD ||
+       fwrite(&_packed[0], 1, _packed.size(), _file) != _packed.size())
+    {
+        //the disk is full or gone, stop trying and let lost() and forEachChunk() report it
+        _lost += rows;
+    }
+    _saved += rows;
+}
+
+bool stepLog::readChunk(std::vector<stepRecord> &steps) const
+{
+    unsigned char head[CHUNK_HEAD];
+    if(fread(head, 1, CHUNK_HEAD, _file) != CHUNK_HEAD || memcmp(head, "MSTP", 4) != 0)
+    {
+        return false;
+    }
+    size_t rows = (size_t)getLE(head + 4, 4);
+    std::vector<unsigned char> packed((size_t)getLE(head + 8, 4));
+    std::vector<unsigned char> cols(rows*STEP_BYTES);
+    if(fread(packed.data(), 1, packed.size(), _file) != packed.size() ||
+       !lzDecompress(packed.data(), packed.size(), cols.data(), cols.size()))
+    {
+        return false;
+    }
+
+    long long tick = (long long)getLE(head + 12, 8), us = (long long)getLE(head + 20, 8);
+    steps.resize(rows);
+    for(size_t i = 0; i < rows; i++)
+    {
+        stepRecord &rec = steps[i];
+        tick += (long long)getLE(&cols[4*i], 4);
+        us += (long long)getLE(&cols[4*rows + 4*i], 4);
+        rec.tick = (long)tick;
+        rec.timeMs = us / 1000.0;
+        rec.x = (int)getLE(&cols[8*rows + 2*i], 2);
+        rec.y = (int)getLE(&cols[10*rows + 2*i], 2);
+        rec.dir = (mDirection)cols[12*rows + i];
+        rec.action = (stepAction)cols[13*rows + i];
+    }
+    return true;
+}
+
+bool stepLog::forEachChunk(const std::function<bool(const stepRecord *steps, size_t count)> &visit) const
+{
+    std::vector<stepRecord> steps;
+    bool ok = !_lost;
+    if(_file && !_lost)
+    {
+        fflush(_file);
+        rewind(_file);
+        for(long long read = 0; read < _saved && ok; read += steps.size())
+        {
+            ok = readChunk(steps);
+            if(ok && !visit(steps.data(), steps.size()))
+            {
+                fseek(_file, 0, SEEK_END);
+                return true;
+            }
+        }
+        //more chunks are appended after this
+        fseek(_file, 0, SEEK_END);
+        if(!ok)
+        {
+            return false;
+        }
+    }
+
+    //what has not been written out yet
+    steps.clear();
+    for(long long i = _saved; i < _total; i++)
+    {
+        steps.push_back(_ring[i % _ring.size()]);
+    }
+    if(!steps.empty())
+    {
+        visit(steps.data(), steps.size());
+    }
+    return ok;
+}
+
+printLimiter::printLimiter(double perSecond, int burst) :
+    _rate(perSecond),
+    _burst(burst)
+{
+    reset();
+}
+
+void printLimiter::reset()
+{
+    _tokens = _burst;
+    _dropped = 0;
+    _last = std::chrono::steady_clock::now();
+}
+
+bool printLimiter::admit()
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    _tokens += _rate * std::chrono::duration<double>(now - _last).count();
+    _tokens = _tokens > _burst ? _burst : _tokens;
+    _last = now;
+    if(_tokens < 1)
+    {
+        _dropped++;
+        return false;
+    }
+    _tokens -= 1;
+    return true;
+}
+
+long printLimiter::takeDropped()
+{
+    long dropped = _dropped;
+    _dropped = 0;
+    return dropped;
+}
@@ -0,0 +1,108 @@
+#ifndef RUN_LOG_H
+#define RUN_LOG_H
+
+#include "mazeState.h"
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+//steps kept in memory, the newest ones, and steps per chunk written out to disk
+#define STEP_RECENT 32768
+#define STEP_CHUNK 8192
+
+//printUI() lines a second the simulator shows once a burst of PRINT_BURST is used up
+#define PRINT_RATE 20
+#define PRINT_BURST 100
+
+enum stepAction
+{
+    aFORWARD,
+    aREVISIT,
+    aBLOCKED,
+    aLEFT,
+    aRIGHT,
+    aPRINT,
+    aFINISH
+};
+
+struct stepRecord
+{
+    long tick;
+    double timeMs;
+    int x, y;
+    mDirection dir;
+    stepAction action;
+};
+
+/*
+ * Every step of a run in memory that stays the same however long the run
+ * is. The newest steps sit in a ring, each time STEP_CHUNK of them have not
+ * been saved yet they are packed a column at a time (deltas for tick and
+ * time), compressed with lzCompress and appended to a temporary file:
+ *   "MSTP" u32 rows u32 packed length i64 first tick i64 first time in us,
+ *   then the compressed columns u32 tick delta, u32 time delta in us,
+ *   u16 x, u16 y, u8 dir, u8 action
+ * Reading back goes through the file a chunk at a time.
+ */
+class stepLog
+{
+public:
+    explicit stepLog(size_t recent = STEP_RECENT, size_t chunk = STEP_CHUNK);
+    ~stepLog();
+
+    void clear();
+    void push(const stepRecord &rec);
+
+    //steps since clear(), on disk or not
+    long long size() const { return _total; }
+    //steps in chunks that could not be written, the disk was full or there is no temporary folder
+    long long lost() const { return _lost; }
+
+    /*
+     * Hands every step to visit in order, up to STEP_CHUNK at a time, and
+     * stops when visit returns false. False if anything could not be read
+     * back or was lost.
+     */
+    bool forEachChunk(const std::function<bool(const stepRecord *steps, size_t count)> &visit) const;
+
+private:
+    stepLog(const stepLog &);
+    stepLog &operator=(const stepLog &);
+
+    void spill();
+    bool readChunk(std::vector<stepRecord> &steps) const;
+
+    std::vector<stepRecord> _ring;
+    size_t _chunk;
+    long long _total;
+    long long _saved;       //steps from the front that are on disk, or lost
+    long long _lost;
+    FILE *_file;
+    std::vector<unsigned char> _raw, _packed;
+};
+
+/*
+ * Token bucket for printUI() output: a burst goes straight through, after
+ * that PRINT_RATE a second. Messages over the limit are only counted so an
+ * AI printing every tick can not bury the window in text.
+ */
+class printLimiter
+{
+public:
+    explicit printLimiter(double perSecond = PRINT_RATE, int burst = PRINT_BURST);
+
+    void reset();
+    bool admit();
+    //messages turned away since the last call
+    long takeDropped();
+
+private:
+    double _rate;
+    double _burst;
+    double _tokens;
+    long _dropped;
+    std::chrono::steady_clock::time_point _last;
+};
+
+#endif // RUN_LOG_H
@@ -0,0 +1,515 @@
+#include "runStats.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <random>
+
+runSummary::runSummary() :
+    runId(0),
+    ticks(0),
+    steps(0),
+    turns(0),
+    revisits(0),
+    prints(0),
+    sensorCalls(0),
+    redundantSensors(0),
+    sensedFraction(0),
+    optimalLength(-1),
+    finished(false),
+    timeToGoalMs(-1),
+    motionTimeS(-1),
+    speedRunCost(-1),
+    optimalSpeedRunCost(-1)
+{
+}
+
+long long newRunId()
+{
+    //a random start per process and a counter through a bijective mix, so
+    //parallel runs never share an id even when they start in the same microsecond
+    static const unsigned long long seed = ((unsigned long long)std::random_device()() << 32) ^ std::random_device()() ^
+            (unsigned long long)std::chrono::system_clock::now().time_since_epoch().count();
+    static std::atomic<unsigned long long> count(0);
+    return (long long)(mixHash(seed + count++) >> 1);
+}
+
+runRecorder::runRecorder() :
+    _running(false),
+    _startX(1),
+    _startY(1),
+    _startDir(dUP),
+    _costs(0),
+    _prints(0),
+    _reachedGoal(false)
+{
+}
+
+void runRecorder::begin(const simState &state, const std::string &maze, const std::string &ai)
+{
+    _running = true;
+    _startX = state.mouseX();
+    _startY = state.mouseY();
+    _startDir = state.mouseDir();
+    _prints = 0;
+    _reachedGoal = false;
+    _steps.clear();
+    _timer.reset();
+    _summary = runSummary();
+    _summary.maze = maze;
+    _summary.ai = ai;
+    _summary.runId = newRunId();
+    _start = std::chrono::steady_clock::now();
+}
+
+double runRecorder::elapsedMs() const
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - _start).count();
+}
+
+void runRecorder::record(const simState &state, stepAction action)
+{
+    if(!_running)
+    {
+        return;
+    }
+    stepRecord rec;
+    rec.tick = state.mouse().ticks;
+    rec.timeMs = elapsedMs();
+    rec.x = state.mouseX();
+    rec.y = state.mouseY();
+    rec.dir = state.mouseDir();
+    rec.action = action;
+    _steps.push(rec);
+    //exploring after the goal is not counted, it does not help the run that found it
+    if(!_reachedGoal && state.isAtGoal())
+    {
+        _reachedGoal = true;
+        _summary.sensedFraction = state.known().sensedFraction();
+    }
+    if(action == aPRINT)
+    {
+        _prints++;
+    }
+    else if(action == aFORWARD || action == aREVISIT)
+    {
+        _timer.forward();
+    }
+    else if(action == aLEFT || action == aRIGHT)
+    {
+        _timer.turn();
+    }
+}
+
+runSummary runRecorder::finish(const simState &state)
+{
+    const mouseState &mouse = state.mouse();
+    _running = false;
+    _summary.ticks = mouse.ticks;
+    _summary.steps = mouse.steps;
+    _summary.turns = mouse.turns;
+    _summary.revisits = mouse.revisits;
+    _summary.prints = _prints;
+    _summary.sensorCalls = mouse.sensorCalls;
+    _summary.redundantSensors = mouse.redundantSensors;
+    if(!_reachedGoal)
+    {
+        _summary.sensedFraction = state.known().sensedFraction();
+    }
+    _summary.finished = mouse.finished && mouse.atGoal;
+    _summary.motionTimeS = _timer.total();
+    if(_summary.finished)
+    {
+        _summary.timeToGoalMs = elapsedMs();
+        _summary.optimalLength = shortestPathLength(state.layout(), _startX, _startY, mouse.x, mouse.y);
+    }
+    if(_costs)
+    {
+        //how good a speed run the mouse could make with what it explored, against the best possible
+        _summary.speedRunCost = planSpeedRun(state.layout(), *_costs, _startX, _startY, _startDir, &state.known()).cost;
+        if((long long)state.layout().width() * state.layout().height() <= PLAN_MAX_CELLS)
+        {
+            _summary.optimalSpeedRunCost = optimalSpeedRun(state.layout(), *_costs, _startX, _startY, _startDir)->cost;
+        }
+    }
+    return _summary;
+}
+
+int shortestPathLength(const mazeLayout &layout, int fromX, int fromY, int toX, int toY)
+{
+    //plain breadth first search, mazes are small and this runs once per run
+    if(!layout.contains(fromX-1, fromY-1) || !layout.contains(toX-1, toY-1))
+    {
+        return -1;
+    }
+    std::vector<int> dist(layout.width()*layout.height(), -1);
+    std::deque<int> open;
+    int start = (fromY-1)*layout.width() + fromX-1;
+    int goal = (toY-1)*layout.width() + toX-1;
+    dist[start] = 0;
+    open.push_back(start);
+    while(!open.empty())
+    {
+        int cell = open.front();
+        open.pop_front();
+        if(cell == goal)
+        {
+            return dist[cell];
+        }
+        int x = cell % layout.width(), y = cell / layout.width();
+        for(int d = 0; d < 4; d++)
+        {
+            mDirection dir = (mDirection)d;
+            int nx = x + stepX(dir), ny = y + stepY(dir);
+            if(layout.contains(nx, ny) && !layout.isWall(x, y, dir) && dist[ny*layout.width() + nx] < 0)
+            {
+                dist[ny*layout.width() + nx] = dist[cell] + 1;
+                open.push_back(ny*layout.width() + nx);
+            }
+        }
+    }
+    return -1;
+}
+
+//FNV-1a, only used to turn names into fixed width ids for the binary files
+static long long nameId(const std::string &name)
+{
+    unsigned long long hash = 14695981039346656037ULL;
+    for(size_t i = 0; i < name.size(); i++)
+    {
+        hash ^= (unsigned char)name[i];
+        hash *= 1099511628211ULL;
+    }
+    return (long long)hash;
+}
+
+columnData::columnData(const std::string &colName, columnType colType) :
+    name(colName),
+    type(colType)
+{
+}
+
+int columnData::width() const
+{
+    switch(type)
+    {
+    case cU8:
+        return 1;
+    case cI32:
+        return 4;
+    case cI64:
+    case cF64:
+        return 8;
+    }
+    return 8;
+}
+
+void columnData::push(long long val)
+{
+    unsigned long long raw = (unsigned long long)val;
+    for(int i = 0; i < width(); i++)
+    {
+        bytes.push_back((raw >> (8*i)) & 0xFF);
+    }
+}
+
+void columnData::pushReal(double val)
+{
+    long long raw;
+    memcpy(&raw, &val, sizeof(raw));
+    push(raw);
+}
+
+double columnData::at(size_t row) const
+{
+    unsigned long long raw = 0;
+    for(int i = width()-1; i >= 0; i--)
+    {
+        raw = (raw << 8) | bytes[row*width() + i];
+    }
+    switch(type)
+    {
+    case cU8:
+        return (double)raw;
+    case cI32:
+        return (double)(int)(unsigned int)raw;
+    case cI64:
+        return (double)(long long)raw;
+    case cF64:
+    {
+        double val;
+        memcpy(&val, &raw, sizeof(val));
+        return val;
+    }
+    }
+    return 0;
+}
+
+static void putU32(FILE *file, unsigned int val)
+{
+    unsigned char buf[4] = {(unsigned char)val, (unsigned char)(val >> 8), (unsigned char)(val >> 16), (unsigned char)(val >> 24)};
+    fwrite(buf, 1, 4, file);
+}
+
+static bool getU32(FILE *file, unsigned int &val)
+{
+    unsigned char buf[4];
+    if(fread(buf, 1, 4, file) != 4)
+    {
+        return false;
+    }
+    val = buf[0] | (buf[1] << 8) | (buf[2] << 16) | ((unsigned int)buf[3] << 24);
+    return true;
+}
+
+bool appendColumns(const std::string &path, const std::vector<columnData> &columns)
+{
+    if(columns.empty())
+    {
+        return true;
+    }
+    FILE *file = fopen(path.c_str(), "ab");
+    if(!file)
+    {
+        return false;
+    }
+    fwrite("MCOL", 1, 4, file);
+    putU32(file, (unsigned int)columns[0].rows());
+    putU32(file, (unsigned int)columns.size());
+    for(size_t i = 0; i < columns.size(); i++)
+    {
+        unsigned char head[2] = {(unsigned char)columns[i].type, (unsigned char)columns[i].name.size()};
+        fwrite(head, 1, 2, file);
+        fwrite(columns[i].name.data(), 1, columns[i].name.size(), file);
+        fwrite(columns[i].bytes.data(), 1, columns[i].bytes.size(), file);
+    }
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+bool readColumns(const std::string &path, std::vector<columnData> &columns)
+{
+    FILE *file = fopen(path.c_str(), "rb");
+    if(!file)
+    {
+        return false;
+    }
+    columns.clear();
+    bool ok = true;
+    bool first = true;
+    char magic[4];
+    while(fread(magic, 1, 4, file) == 4)
+    {
+        unsigned int rows, count;
+        if(memcmp(magic, "MCOL", 4) != 0 || !getU32(file, rows) || !getU32(file, count) ||
+           (!first && count != columns.size()))
+        {
+            ok = false;
+            break;
+        }
+        for(unsigned int i = 0; i < count && ok; i++)
+        {
+            unsigned char head[2];
+            char name[256];
+            if(fread(head, 1, 2, file) != 2 || fread(name, 1, head[1], file) != head[1])
+            {
+                ok = false;
+                break;
+            }
+            //the first block sets the columns, every later one has to have the same names and types in the same order
+            if(first)
+            {
+                columns.push_back(columnData(std::string(name, head[1]), (columnType)head[0]));
+            }
+            else if(i >= columns.size() || columns[i].name != std::string(name, head[1]))
+            {
+                ok = false;
+                break;
+            }
+            columnData &col = columns[i];
+            size_t len = (size_t)rows * col.width();
+            size_t old = col.bytes.size();
+            col.bytes.resize(old + len);
+            if(col.type != head[0] || fread(col.bytes.data() + old, 1, len, file) != len)
+            {
+                ok = false;
+            }
+        }
+        if(!ok)
+        {
+            break;
+        }
+        first = false;
+    }
+    fclose(file);
+    return ok;
+}
+
+//a field inside double quotes, with any quote in it doubled
+static std::string csvQuoted(const std::string &text)
+{
+    std::string out = "\"";
+    for(size_t i = 0; i < text.size(); i++)
+    {
+        out += text[i];
+        if(text[i] == '"')
+        {
+            out += '"';
+        }
+    }
+    return out + "\"";
+}
+
+//true if the file is missing or empty, so the caller knows to write a header
+static FILE *openCsv(const std::string &path, bool &isNew)
+{
+    FILE *file = fopen(path.c_str(), "a");
+    if(file)
+    {
+        fseek(file, 0, SEEK_END);
+        isNew = ftell(file) == 0;
+    }
+    return file;
+}
+
+static const char *actionName(stepAction action)
+{
+    switch(action)
+    {
+    case aFORWARD:
+        return "forward";
+    case aREVISIT:
+        return "revisit";
+    case aBLOCKED:
+        return "blocked";
+    case aLEFT:
+        return "left";
+    case aRIGHT:
+        return "right";
+    case aPRINT:
+        return "print";
+    case aFINISH:
+        return "finish";
+    }
+    return "";
+}
+
+bool appendRunCsv(const std::string &path, const runSummary &summary)
+{
+    bool isNew = false;
+    FILE *file = openCsv(path, isNew);
+    if(!file)
+    {
+        return false;
+    }
+    if(isNew)
+    {
+        fprintf(file, "run_id,maze,ai,finished,ticks,steps,turns,revisits,optimal_length,time_to_goal_ms,prints,motion_time_s,speed_run_cost,optimal_speed_run_cost,sensor_calls,redundant_sensors,sensed_fraction\n");
+    }
+    fprintf(file, "%lld,%s,%s,%d,%ld,%ld,%ld,%ld,%d,%.3f,%ld,%.4f,%.2f,%.2f,%ld,%ld,%.4f\n",
+            summary.runId, csvQuoted(summary.maze).c_str(), csvQuoted(summary.ai).c_str(), summary.finished ? 1 : 0,
+            summary.ticks, summary.steps, summary.turns, summary.revisits,
+            summary.optimalLength, summary.timeToGoalMs, summary.prints, summary.motionTimeS,
+            summary.speedRunCost, summary.optimalSpeedRunCost,
+            summary.sensorCalls, summary.redundantSensors, summary.sensedFraction);
+    bool ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+bool appendRunColumns(const std::string &path, const runSummary &summary)
+{
+    std::vector<columnData> cols;
+    cols.push_back(columnData("run_id", cI64));
+    cols.push_back(columnData("maze_id", cI64));
+    cols.push_back(columnData("ai_id", cI64));
+    cols.push_back(columnData("finished", cU8));
+    cols.push_back(columnData("ticks", cI32));
+    cols.push_back(columnData("steps", cI32));
+    cols.push_back(columnData("turns", cI32));
+    cols.push_back(columnData("revisits", cI32));
+    cols.push_back(columnData("optimal_length", cI32));
+    cols.push_back(columnData("time_to_goal_ms", cF64));
+    cols.push_back(columnData("prints", cI32));
+    cols.push_back(columnData("motion_time_s", cF64));
+    cols.push_back(columnData("speed_run_cost", cF64));
+    cols.push_back(columnData("optimal_speed_run_cost", cF64));
+    cols.push_back(columnData("sensor_calls", cI32));
+    cols.push_back(columnData("redundant_sensors", cI32));
+    cols.push_back(columnData("sensed_fraction", cF64));
+    cols[0].push(summary.runId);
+    cols[1].push(nameId(summary.maze));
+    cols[2].push(nameId(summary.ai));
+    cols[3].push(summary.finished);
+    cols[4].push(summary.ticks);
+    cols[5].push(summary.steps);
+    cols[6].push(summary.turns);
+    cols[7].push(summary.revisits);
+    cols[8].push(summary.optimalLength);
+    cols[9].pushReal(summary.timeToGoalMs);
+    cols[10].push(summary.prints);
+    cols[11].pushReal(summary.motionTimeS);
+    cols[12].pushReal(summary.speedRunCost);
+    cols[13].pushReal(summary.optimalSpeedRunCost);
+    cols[14].push(summary.sensorCalls);
+    cols[15].push(summary.redundantSensors);
+    cols[16].pushReal(summary.sensedFraction);
+    return appendColumns(path, cols);
+}
+
+bool appendStepCsv(const std::string &path, long long runId, const stepLog &steps)
+{
+    bool isNew = false;
+    FILE *file = openCsv(path, isNew);
+    if(!file)
+    {
+        return false;
+    }
+    if(isNew)
+    {
+        fprintf(file, "run_id,tick,time_ms,x,y,dir,action\n");
+    }
+    bool ok = steps.forEachChunk([&](const stepRecord *chunk, size_t count)
+    {
+        for(size_t i = 0; i < count; i++)
+        {
+            const stepRecord &rec = chunk[i];
+            fprintf(file, "%lld,%ld,%.3f,%d,%d,%d,%s\n", runId, rec.tick, rec.timeMs, rec.x, rec.y, (int)rec.dir, actionName(rec.action));
+        }
+        return !ferror(file);
+    });
+    ok = ok && !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+bool appendStepColumns(const std::string &path, long long runId, const stepLog &steps)
+{
+    bool written = true;
+    bool ok = steps.forEachChunk([&](const stepRecord *chunk, size_t count)
+    {
+        std::vector<columnData> cols;
+        cols.push_back(columnData("run_id", cI64));
+        cols.push_back(columnData("tick", cI32));
+        cols.push_back(columnData("time_ms", cF64));
+        cols.push_back(columnData("x", cI32));
+        cols.push_back(columnData("y", cI32));
+        cols.push_back(columnData("dir", cU8));
+        cols.push_back(columnData("action", cU8));
+        for(size_t i = 0; i < count; i++)
+        {
+            const stepRecord &rec = chunk[i];
+            cols[0].push(runId);
+            cols[1].push(rec.tick);
+            cols[2].pushReal(rec.timeMs);
+            cols[3].push(rec.x);
+            cols[4].push(rec.y);
+            cols[5].push(rec.dir);
+            cols[6].push(rec.action);
+        }
+        written = appendColumns(path, cols);
+        return written;
+    });
+    return ok && written;
+}
@@ -0,0 +1,122 @@
+#ifndef RUN_STATS_H
+#define RUN_STATS_H
+
+#include "mazeState.h"
+#include "motionScore.h"
+#include "pathPlanner.h"
+#include "runLog.h"
+#include <chrono>
+#include <string>
+#include <vector>
+
+#define STATS_RUNS_CSV "runs.csv"
+#define STATS_RUNS_COL "runs.mcol"
+#define STATS_STEPS_CSV "steps.csv"
+#define STATS_STEPS_COL "steps.mcol"
+
+struct runSummary
+{
+    long long runId;        //random, unique across threads and processes writing the same files
+    std::string maze;
+    std::string ai;
+    long ticks;
+    long steps;
+    long turns;
+    long revisits;
+    long prints;
+    long sensorCalls;
+    long redundantSensors;
+    double sensedFraction;  //of all wall sides, by the first time the mouse was in the goal, or the end if never
+    int optimalLength;
+    bool finished;          //foundFinish() was called inside the goal
+
+    double timeToGoalMs;
+    double motionTimeS;
+    double speedRunCost;
+    double optimalSpeedRunCost;    //-1 on mazes over PLAN_MAX_CELLS
+
+    runSummary();
+};
+
+/*
+ * Collects one run's statistics as it happens. The recorder never touches
+ * the simState, the caller reports each action after applying it.
+ */
+class runRecorder
+{
+public:
+    runRecorder();
+
+    void setScorer(const motionScorer *scorer) { _timer = motionTimer(scorer); }
+    void setPlanner(const plannerCosts *costs) { _costs = costs; }
+    void begin(const simState &state, const std::string &maze, const std::string &ai);
+    void record(const simState &state, stepAction action);
+    runSummary finish(const simState &state);
+
+    bool isRunning() const { return _running; }
+    //kinematic seconds so far, -1 without a scorer
+    double motionTime() const { return _timer.total(); }
+    //every step of the current or last run, only the newest are kept in memory
+    const stepLog &steps() const { return _steps; }
+
+private:
+    double elapsedMs() const;
+
+    bool _running;
+    int _startX, _startY;
+    mDirection _startDir;
+    const plannerCosts *_costs;
+    long _prints;
+    bool _reachedGoal;
+    runSummary _summary;
+    motionTimer _timer;
+    stepLog _steps;
+    std::chrono::steady_clock::time_point _start;
+};
+
+//cells on the shortest path between two 1 based cells, -1 if there is none
+int shortestPathLength(const mazeLayout &layout, int fromX, int fromY, int toX, int toY);
+
+/*
+ * Columnar files are a list of appended blocks. Each block holds the same
+ * columns for a batch of rows, every column stored contiguously:
+ *   "MCOL" u32 rows u32 columns, then per column: u8 type, u8 name length,
+ *   name, rows * width bytes of little endian data.
+ * Appending never rewrites earlier blocks. Reading fails on a block whose
+ * columns differ from the first one, such as rows from an older layout.
+ */
+enum columnType
+{
+    cU8,
+    cI32,
+    cI64,
+    cF64
+};
+
+struct columnData
+{
+    std::string name;
+    columnType type;
+    std::vector<unsigned char> bytes;
+
+    columnData(const std::string &colName = "", columnType colType = cI64);
+    int width() const;
+    size_t rows() const { return bytes.size() / width(); }
+    void push(long long val);
+    void pushReal(double val);
+    double at(size_t row) const;
+};
+
+bool appendColumns(const std::string &path, const std::vector<columnData> &columns);
+bool readColumns(const std::string &path, std::vector<columnData> &columns);
+
+//what runRecorder::begin() gives each run, for rows of runs that were not recorded
+long long newRunId();
+
+bool appendRunCsv(const std::string &path, const runSummary &summary);
+bool appendRunColumns(const std::string &path, const runSummary &summary);
+//steps are read back from the log and written a chunk at a time, one columns block per chunk
+bool appendStepCsv(const std::string &path, long long runId, const stepLog &steps);
+bool appendStepColumns(const std::string &path, long long runId, const stepLog &steps);
+
+#endif
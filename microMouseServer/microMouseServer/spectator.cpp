@@ -0,0 +1,437 @@
+#include "spectator.h"
+#include <cstring>
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#ifdef MSG_NOSIGNAL
+#define SEND_FLAGS MSG_NOSIGNAL
+#else
+#define SEND_FLAGS 0
+#endif
+
+static void putU16(std::string &out, int val)
+{
+    out += (char)(val & 0xFF);
+    out += (char)((val >> 8) & 0xFF);
+}
+
+static std::string poseMessage(int x, int y, mDirection dir)
+{
+    std::string out(1, (char)sPOSE);
+    putU16(out, x);
+    putU16(out, y);
+    out += (char)dir;
+    return out;
+}
+
+spectatorStream::spectatorStream() :
+    _x(0),
+    _y(0),
+    _dir(dUP),
+    _resync(false),
+    _listenFd(-1),
+    _stop(false),
+    _viewers(0)
+{
+    _wakeFd[0] = _wakeFd[1] = -1;
+}
+
+spectatorStream::~spectatorStream()
+{
+    close();
+}
+
+void spectatorStream::setMaze(const mazeLayout &layout)
+{
+    if(!isListening())
+    {
+        return;
+    }
+    std::string maze(1, (char)sMAZE);
+    putU16(maze, layout.width());
+    putU16(maze, layout.height());
+    putU16(maze, layout.startX());
+    putU16(maze, layout.startY());
+    maze += (char)layout.startDir();
+    maze.reserve(maze.size() + layout.width()*layout.height());
+    for(int y = 0; y < layout.height(); y++)
+    {
+        for(int x = 0; x < layout.width(); x++)
+        {
+            maze += (char)(layout.walls(x, y) | (layout.isGoal(x, y) ? GOAL_FLAG : 0));
+        }
+    }
+
+    //a new maze puts the mouse back on the start, viewers get it after whatever they have not seen yet
+    bool wakeWriter;
+    {
+        std::lock_guard<std::mutex> hold(_lock);
+        _maze = maze;
+        _x = layout.startX();
+        _y = layout.startY();
+        _dir = layout.startDir();
+        wakeWriter = postLocked(maze + poseMessage(_x, _y, _dir));
+    }
+    if(wakeWriter)
+    {
+        wake();
+    }
+}
+
+std::string spectatorStream::snapshot() const
+{
+    //nothing to show before the first maze
+    return _maze.empty() ? _maze : _maze + poseMessage(_x, _y, _dir);
+}
+
+void spectatorStream::post(const std::string &bytes)
+{
+    bool wakeWriter;
+    {
+        std::lock_guard<std::mutex> hold(_lock);
+        wakeWriter = postLocked(bytes);
+    }
+    if(wakeWriter)
+    {
+        wake();
+    }
+}
+
+bool spectatorStream::postLocked(const std::string &bytes)
+{
+    bool wasEmpty = _pending.empty();
+    //nobody is reading fast enough, throw the backlog away and send everyone a snapshot instead
+    if(_pending.size() > SPECTATOR_MAX_BACKLOG)
+    {
+        _pending.clear();
+        _resync = true;
+    }
+    else
+    {
+        _pending += bytes;
+    }
+    return wasEmpty;
+}
+
+void spectatorStream::wake()
+{
+#ifndef _WIN32
+    //the pipe is non blocking, if it is full the writer is awake anyway
+    char byte = 0;
+    ssize_t sent = write(_wakeFd[1], &byte, 1);
+    (void)sent;
+#endif
+}
+
+void spectatorStream::mouseMoved(const simState &state)
+{
+    if(!isListening())
+    {
+        return;
+    }
+
+    //work out the smallest message that takes a viewer from the last pose to this one, and queue it
+    //before the lock is let go so a snapshot taken in between can never already hold the new pose
+    int x = state.mouseX(), y = state.mouseY();
+    mDirection dir = state.mouseDir();
+    std::string delta;
+    bool wakeWriter;
+    {
+        std::lock_guard<std::mutex> hold(_lock);
+        if(x == _x && y == _y && dir == _dir)
+        {
+            return;
+        }
+        if(x == _x && y == _y && dir == leftOf(_dir))
+        {
+            delta = (char)sLEFT;
+        }
+        else if(x == _x && y == _y && dir == rightOf(_dir))
+        {
+            delta = (char)sRIGHT;
+        }
+        else if(dir == _dir && x == _x + stepX(dir) && y == _y + stepY(dir))
+        {
+            delta = (char)sFORWARD;
+        }
+        else
+        {
+            delta = poseMessage(x, y, dir);
+        }
+        _x = x;
+        _y = y;
+        _dir = dir;
+        wakeWriter = postLocked(delta);
+    }
+    if(wakeWriter)
+    {
+        wake();
+    }
+}
+
+void spectatorStream::printed(const simState &, const char *mesg)
+{
+    if(!isListening())
+    {
+        return;
+    }
+    size_t len = strlen(mesg);
+    len = len > 0xFFFF ? 0xFFFF : len;
+    std::string out(1, (char)sPRINT);
+    putU16(out, (int)len);
+    out.append(mesg, len);
+    post(out);
+}
+
+void spectatorStream::finished(const simState &state)
+{
+    if(!isListening())
+    {
+        return;
+    }
+    std::string out(1, (char)sFINISH);
+    out += (char)(state.mouse().atGoal ? 1 : 0);
+    post(out);
+}
+
+#ifdef _WIN32
+bool spectatorStream::listen(const std::string &, std::string &error)
+{
+    error = "ERROR 210: spectator streams need Unix sockets";
+    return false;
+}
+
+void spectatorStream::close()
+{
+}
+
+void spectatorStream::writerLoop()
+{
+}
+
+bool spectatorStream::flush(viewer &)
+{
+    return false;
+}
+#else
+void spectatorStream::queue(viewer &client, const std::string &bytes)
+{
+    if(!bytes.empty())
+    {
+        client.out.push_back(bytes);
+        client.queued += bytes.size();
+    }
+}
+
+void spectatorStream::skipAhead(viewer &client, const std::string &snap)
+{
+    //a message that is half way out has to be finished or the viewer loses track
+    while(client.out.size() > (client.sent ? 1u : 0u))
+    {
+        client.queued -= client.out.back().size();
+        client.out.pop_back();
+    }
+    queue(client, snap);
+}
+
+bool spectatorStream::listen(const std::string &path, std::string &error)
+{
+    close();
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if(path.size() >= sizeof(addr.sun_path))
+    {
+        error = "ERROR 210: spectator socket path is too long";
+        return false;
+    }
+    strcpy(addr.sun_path, path.c_str());
+
+    //a socket left behind by a crashed server would make bind fail, one a live server still answers on is not ours
+    struct stat info;
+    if(stat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode))
+    {
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        bool live = probe >= 0 && connect(probe, (sockaddr *)&addr, sizeof(addr)) == 0;
+        if(probe >= 0)
+        {
+            ::close(probe);
+        }
+        if(live)
+        {
+            error = std::string("ERROR 210: another server is already streaming on ") + path;
+            return false;
+        }
+        unlink(path.c_str());
+    }
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0 || bind(fd, (sockaddr *)&addr, sizeof(addr)) != 0 || ::listen(fd, 8) != 0 || pipe(_wakeFd) != 0)
+    {
+        error = std::string("ERROR 210: could not listen on ") + path + ": " + strerror(errno);
+        if(fd >= 0)
+        {
+            ::close(fd);
+        }
+        return false;
+    }
+    fcntl(fd, F_SETFL, O_NONBLOCK);
+    fcntl(_wakeFd[0], F_SETFL, O_NONBLOCK);
+    fcntl(_wakeFd[1], F_SETFL, O_NONBLOCK);
+
+    _path = path;
+    _listenFd = fd;
+    _stop = false;
+    _writer = std::thread(&spectatorStream::writerLoop, this);
+    return true;
+}
+
+void spectatorStream::close()
+{
+    if(_listenFd < 0)
+    {
+        return;
+    }
+    _stop = true;
+    char byte = 0;
+    ssize_t sent = write(_wakeFd[1], &byte, 1);
+    (void)sent;
+    _writer.join();
+
+    for(size_t i = 0; i < _clients.size(); i++)
+    {
+        ::close(_clients[i].fd);
+    }
+    _clients.clear();
+    _viewers = 0;
+    ::close(_listenFd);
+    ::close(_wakeFd[0]);
+    ::close(_wakeFd[1]);
+    _listenFd = _wakeFd[0] = _wakeFd[1] = -1;
+    unlink(_path.c_str());
+}
+
+bool spectatorStream::flush(viewer &client)
+{
+    while(!client.out.empty())
+    {
+        const std::string &front = client.out.front();
+        ssize_t sent = send(client.fd, front.data() + client.sent, front.size() - client.sent, MSG_DONTWAIT | SEND_FLAGS);
+        if(sent < 0)
+        {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        client.sent += sent;
+        client.queued -= sent;
+        if(client.sent == front.size())
+        {
+            client.out.pop_front();
+            client.sent = 0;
+        }
+    }
+    return true;
+}
+
+void spectatorStream::writerLoop()
+{
+    std::vector<pollfd> fds;
+    bool stopping = false;
+    while(!stopping)
+    {
+        stopping = _stop;
+        fds.clear();
+        pollfd wake = {_wakeFd[0], POLLIN, 0};
+        pollfd incoming = {_listenFd, POLLIN, 0};
+        fds.push_back(wake);
+        fds.push_back(incoming);
+        for(size_t i = 0; i < _clients.size(); i++)
+        {
+            pollfd out = {_clients[i].fd, (short)(POLLIN | (_clients[i].out.empty() ? 0 : POLLOUT)), 0};
+            fds.push_back(out);
+        }
+        if(!stopping)
+        {
+            poll(&fds[0], fds.size(), 1000);
+        }
+
+        char drain[64];
+        while(read(_wakeFd[0], drain, sizeof(drain)) > 0)
+        {
+        }
+
+        //new viewers start from a snapshot
+        size_t known = _clients.size();
+        for(int fd = accept(_listenFd, NULL, NULL); fd >= 0; fd = accept(_listenFd, NULL, NULL))
+        {
+            fcntl(fd, F_SETFL, O_NONBLOCK);
+#ifdef SO_NOSIGPIPE
+            int on = 1;
+            setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+            viewer client;
+            client.fd = fd;
+            client.sent = 0;
+            client.queued = 0;
+            _clients.push_back(client);
+        }
+
+        //take everything posted so far, the snapshot is the state right after it
+        std::string batch, snap;
+        std::vector<bool> behind(_clients.size(), false);
+        bool resync;
+        {
+            std::lock_guard<std::mutex> hold(_lock);
+            batch.swap(_pending);
+            resync = _resync;
+            _resync = false;
+            bool needSnap = resync || known < _clients.size();
+            for(size_t i = 0; i < known; i++)
+            {
+                behind[i] = _clients[i].queued + batch.size() > SPECTATOR_MAX_BACKLOG + _maze.size();
+                needSnap = needSnap || behind[i];
+            }
+            if(needSnap)
+            {
+                snap = snapshot();
+            }
+        }
+
+        std::vector<viewer> keep;
+        for(size_t i = 0; i < _clients.size(); i++)
+        {
+            viewer &client = _clients[i];
+            bool fresh = i >= known;
+            if(fresh || resync || behind[i])
+            {
+                skipAhead(client, snap);
+            }
+            else
+            {
+                queue(client, batch);
+            }
+
+            //viewers never send anything, readable means they hung up
+            char ignored[64];
+            bool open = fresh || !(fds[i+2].revents & (POLLIN | POLLHUP | POLLERR)) ||
+                        recv(client.fd, ignored, sizeof(ignored), MSG_DONTWAIT) > 0;
+            if(open && flush(client))
+            {
+                keep.push_back(client);
+            }
+            else
+            {
+                ::close(client.fd);
+            }
+        }
+        _clients.swap(keep);
+        _viewers = (int)_clients.size();
+    }
+}
+#endif
@@ -0,0 +1,99 @@
+#ifndef SPECTATOR_H
+#define SPECTATOR_H
+
+#include "mouseAI.h"
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define SPECTATOR_PATH "micromouse.sock"
+//a viewer this far behind is dropped back to a fresh snapshot
+#define SPECTATOR_MAX_BACKLOG (256*1024)
+
+/*
+ * Stream format, every number little endian, positions 1 based:
+ *   'M' u16 width, u16 height, u16 startX, u16 startY, u8 startDir,
+ *       then one byte per cell, row by row from the bottom: the wall
+ *       nibble indexed by mDirection, or'd with GOAL_FLAG on goal cells
+ *   'P' u16 x, u16 y, u8 dir     where the mouse is now
+ *   'F' 'L' 'R'                  one step forward, a turn left or right
+ *   'S' u16 length, text         printUI() message
+ *   'E' u8 atGoal                foundFinish() was called
+ * A viewer gets 'M' and 'P' when it connects and deltas after that.
+ */
+enum spectatorOp
+{
+    sMAZE = 'M',
+    sPOSE = 'P',
+    sFORWARD = 'F',
+    sLEFT = 'L',
+    sRIGHT = 'R',
+    sPRINT = 'S',
+    sFINISH = 'E'
+};
+
+/*
+ * Serves the stream on a Unix socket. Events only append to a buffer under
+ * a short lock, a writer thread owns the sockets, so a slow or stuck viewer
+ * can never hold up the simulation. Viewers that fall too far behind skip
+ * ahead to a snapshot of the current maze and pose.
+ */
+class spectatorStream : public aiListener
+{
+public:
+    spectatorStream();
+    ~spectatorStream();
+
+    bool listen(const std::string &path, std::string &error);
+    void close();
+    bool isListening() const { return _listenFd >= 0; }
+    int viewers() const { return _viewers; }
+
+    void setMaze(const mazeLayout &layout);
+    void mouseMoved(const simState &state);
+    void printed(const simState &state, const char *mesg);
+    void finished(const simState &state);
+
+private:
+    //whole messages waiting for one viewer, sent counts into the front chunk
+    struct viewer
+    {
+        int fd;
+        std::deque<std::string> out;
+        size_t sent;
+        size_t queued;
+    };
+
+    spectatorStream(const spectatorStream &);
+    spectatorStream &operator=(const spectatorStream &);
+
+    void post(const std::string &bytes);
+    //appends with _lock held, true if the writer has to be woken
+    bool postLocked(const std::string &bytes);
+    void wake();
+    std::string snapshot() const;
+    void writerLoop();
+    static void queue(viewer &client, const std::string &bytes);
+    static void skipAhead(viewer &client, const std::string &snap);
+    bool flush(viewer &client);
+
+    std::mutex _lock;
+    std::string _pending;
+    std::string _maze;
+    int _x, _y;
+    mDirection _dir;
+    bool _resync;
+
+    std::string _path;
+    int _listenFd;
+    int _wakeFd[2];
+    std::atomic<bool> _stop;
+    std::atomic<int> _viewers;
+    std::thread _writer;
+    std::vector<viewer> _clients;
+};
+
+#endif // SPECTATOR_H
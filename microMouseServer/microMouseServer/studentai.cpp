@@ -1,7 +1,7 @@
 
-#include "micromouseserver.h"
+#include "studentai.h"
 
-void microMouseServer::studentAI()
+void studentMouse::studentAI()
 {
 /*
  * The following are the eight functions that you can call. Feel free to create your own fuctions as well.
@@ -23,3 +23,16 @@ void microMouseServer::studentAI()
 */
 
 }
+
+unsigned long long studentMouse::stateHash() const
+{
+/*
+ * Start pose sweeps call this to spot a mouse going round in circles. Return 0 if studentAI() keeps nothing between
+ * calls (no member variables or statics), or a hash of everything it does keep, for example mixHash(count ^ mixHash(turns))
+ * for two counters. Two calls that return the same value have to mean studentAI() will do the same thing next.
+ *
+ * Left as AI_STATE_UNKNOWN a sweep can not tell a loop from a long search and every looping start pose runs until it
+ * times out.
+ */
+    return AI_STATE_UNKNOWN;
+}
@@ -0,0 +1,15 @@
+#ifndef STUDENTAI_H
+#define STUDENTAI_H
+
+#include "mouseAI.h"
+
+//the AI students write, its studentAI() lives in studentai.cpp
+class studentMouse : public mouseAI
+{
+public:
+    void studentAI();
+    //see studentai.cpp, sweeps can only tell a mouse is in a loop once this is filled in
+    unsigned long long stateHash() const;
+};
+
+#endif // STUDENTAI_H
@@ -0,0 +1,132 @@
+#include "sweep.h"
+#include <atomic>
+#include <thread>
+#include <unordered_set>
+
+sweepMap::sweepMap(int width, int height) :
+    _width(width),
+    _height(height),
+    _runs(width*height*4)
+{
+}
+
+int sweepMap::successes(int x, int y) const
+{
+    int found = 0;
+    for(int d = 0; d < 4; d++)
+    {
+        found += run(x, y, (mDirection)d).outcome == oGOAL;
+    }
+    return found;
+}
+
+double sweepMap::meanSteps(int x, int y) const
+{
+    long steps = 0;
+    int found = 0;
+    for(int d = 0; d < 4; d++)
+    {
+        const sweepRun &r = run(x, y, (mDirection)d);
+        if(r.outcome == oGOAL)
+        {
+            steps += r.steps;
+            found++;
+        }
+    }
+    return found ? (double)steps / found : -1;
+}
+
+int sweepMap::count(sweepOutcome outcome) const
+{
+    int found = 0;
+    for(size_t i = 0; i < _runs.size(); i++)
+    {
+        found += _runs[i].outcome == outcome;
+    }
+    return found;
+}
+
+//one run with no recorder or listener, seen is scratch space kept between runs
+static sweepRun sweepOne(std::shared_ptr<const mazeLayout> layout, mouseAI &ai, int x, int y, mDirection dir,
+                         long maxTicks, std::unordered_set<unsigned long long> &seen)
+{
+    simState sim(layout);
+    sim.reset(x+1, y+1, dir);
+    ai.attach(&sim);
+    bool detectLoops = ai.stateHash() != AI_STATE_UNKNOWN;
+    seen.clear();
+
+    sweepRun result;
+    while(true)
+    {
+        if(sim.isFinished())
+        {
+            result.outcome = sim.mouse().atGoal ? oGOAL : oFALSE_FINISH;
+            break;
+        }
+        if(sim.isAtGoal())
+        {
+            result.outcome = oGOAL;
+            break;
+        }
+        if(sim.mouse().ticks >= maxTicks)
+        {
+            result.outcome = oTIMEOUT;
+            break;
+        }
+        if(detectLoops)
+        {
+            //the AI only sees walls, so the same pose and memory always lead to the same moves
+            unsigned long long pose = ((unsigned long long)((sim.mouseY()-1)*layout->width() + sim.mouseX()-1) << 2) | sim.mouseDir();
+            if(!seen.insert(mixHash(pose ^ mixHash(ai.stateHash()))).second)
+            {
+                result.outcome = oLOOP;
+                break;
+            }
+        }
+        ai.step();
+    }
+    result.ticks = sim.mouse().ticks;
+    result.steps = sim.mouse().steps;
+    ai.attach(0);
+    return result;
+}
+
+sweepMap sweepStarts(std::shared_ptr<const mazeLayout> layout, const aiFactory &makeAI, long maxTicks, int threads)
+{
+    sweepMap map(layout->width(), layout->height());
+    int cells = layout->width()*layout->height();
+    if(threads <= 0)
+    {
+        threads = (int)std::thread::hardware_concurrency();
+    }
+    threads = threads < 1 ? 1 : (threads > cells ? cells : threads);
+
+    //cells are handed out one at a time so slow corners do not hold up a whole thread
+    std::atomic<int> next(0);
+    auto worker = [&]()
+    {
+        std::unordered_set<unsigned long long> seen;
+        for(int cell = next++; cell < cells; cell = next++)
+        {
+            int x = cell % layout->width(), y = cell / layout->width();
+            for(int d = 0; d < 4; d++)
+            {
+                std::unique_ptr<mouseAI> ai(makeAI());
+                map.run(x, y, (mDirection)d) = sweepOne(layout, *ai, x, y, (mDirection)d, maxTicks, seen);
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for(int i = 1; i < threads; i++)
+    {
+        pool.push_back(std::thread(worker));
+    }
+    worker();
+    for(size_t i = 0; i < pool.size(); i++)
+    {
+        pool[i].join();
+    }
+    return map;
+}
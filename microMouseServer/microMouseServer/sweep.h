@@ -0,0 +1,60 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include "mouseAI.h"
+#include <functional>
+#include <memory>
+#include <vector>
+
+//ticks per start pose when the caller has no limit of its own
+#define SWEEP_MAX_TICKS 100000
+
+enum sweepOutcome
+{
+    oGOAL,          //entered the goal
+    oLOOP,          //came back to a cell, heading and AI state it had already been in
+    oTIMEOUT,       //ran out of ticks
+    oFALSE_FINISH   //called foundFinish() outside the goal
+};
+
+struct sweepRun
+{
+    sweepOutcome outcome;
+    long ticks;
+    long steps;
+};
+
+//outcome of a run from every cell and heading, cells are 0 based like mazeLayout
+class sweepMap
+{
+public:
+    sweepMap(int width = 0, int height = 0);
+
+    int width() const { return _width; }
+    int height() const { return _height; }
+    const sweepRun &run(int x, int y, mDirection dir) const { return _runs[(y*_width + x)*4 + dir]; }
+    sweepRun &run(int x, int y, mDirection dir) { return _runs[(y*_width + x)*4 + dir]; }
+
+    //headings that reach the goal from a cell, 0 to 4
+    int successes(int x, int y) const;
+    //mean steps of the runs from a cell that reach the goal, -1 if none do
+    double meanSteps(int x, int y) const;
+    int count(sweepOutcome outcome) const;
+    int runs() const { return (int)_runs.size(); }
+
+private:
+    int _width, _height;
+    std::vector<sweepRun> _runs;
+};
+
+typedef std::function<mouseAI *()> aiFactory;
+
+/*
+ * Runs a fresh AI from every start pose of the maze, cells shared out over
+ * threads (0 uses one per core). Runs end when the mouse enters the goal,
+ * loops or times out. makeAI is called from the worker threads, so the AI
+ * may not keep anything in globals or statics.
+ */
+sweepMap sweepStarts(std::shared_ptr<const mazeLayout> layout, const aiFactory &makeAI, long maxTicks, int threads = 0);
+
+#endif // SWEEP_H
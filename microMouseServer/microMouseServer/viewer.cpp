@@ -0,0 +1,234 @@
+/*
+ * Spectator client for the stream served by the simulator or microMouseCli
+ * --spectate. Draws the maze and the mouse in the terminal, or with
+ * --events prints every message it gets, one per line.
+ */
+#include "spectator.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+//what a viewer knows, rebuilt from the stream alone
+struct viewState
+{
+    int width, height;
+    std::vector<unsigned char> cells;
+    int x, y;
+    mDirection dir;
+    std::vector<std::string> log;
+
+    viewState() : width(0), height(0), x(0), y(0), dir(dUP) {}
+    unsigned char cell(int cx, int cy) const { return cells[cy*width + cx]; }
+};
+
+static int getU16(const char *at)
+{
+    return (unsigned char)at[0] | ((unsigned char)at[1] << 8);
+}
+
+//length of the message at the front of the buffer, 0 if it has not all arrived yet, -1 if it is garbage
+static long messageLength(const std::string &buf)
+{
+    if(buf.empty())
+    {
+        return 0;
+    }
+    switch(buf[0])
+    {
+    case sMAZE:
+        return buf.size() < 10 ? 0 : 10 + (long)getU16(&buf[1]) * getU16(&buf[3]);
+    case sPOSE:
+        return 6;
+    case sFORWARD:
+    case sLEFT:
+    case sRIGHT:
+        return 1;
+    case sPRINT:
+        return buf.size() < 3 ? 0 : 3 + getU16(&buf[1]);
+    case sFINISH:
+        return 2;
+    default:
+        return -1;
+    }
+}
+
+static void apply(viewState &view, const char *msg, bool events)
+{
+    static const char dirNames[] = "RDLU";
+    switch(msg[0])
+    {
+    case sMAZE:
+        view.width = getU16(msg + 1);
+        view.height = getU16(msg + 3);
+        view.cells.assign(msg + 10, msg + 10 + view.width*view.height);
+        if(events)
+        {
+            printf("maze %dx%d start %d %d %c\n", view.width, view.height, getU16(msg + 5), getU16(msg + 7), dirNames[msg[9] & 3]);
+        }
+        break;
+    case sPOSE:
+        view.x = getU16(msg + 1);
+        view.y = getU16(msg + 3);
+        view.dir = (mDirection)(msg[5] & 3);
+        if(events)
+        {
+            printf("pose %d %d %c\n", view.x, view.y, dirNames[view.dir]);
+        }
+        break;
+    case sFORWARD:
+        view.x += stepX(view.dir);
+        view.y += stepY(view.dir);
+        if(events)
+        {
+            printf("forward %d %d\n", view.x, view.y);
+        }
+        break;
+    case sLEFT:
+        view.dir = leftOf(view.dir);
+        if(events)
+        {
+            printf("left %c\n", dirNames[view.dir]);
+        }
+        break;
+    case sRIGHT:
+        view.dir = rightOf(view.dir);
+        if(events)
+        {
+            printf("right %c\n", dirNames[view.dir]);
+        }
+        break;
+    case sPRINT:
+        view.log.push_back(std::string(msg + 3, getU16(msg + 1)));
+        if(view.log.size() > 5)
+        {
+            view.log.erase(view.log.begin());
+        }
+        if(events)
+        {
+            printf("print %s\n", view.log.back().c_str());
+        }
+        break;
+    case sFINISH:
+        view.log.push_back(msg[1] ? "Found end of maze." : "foundFinish() outside the goal.");
+        if(events)
+        {
+            printf("finish %d\n", msg[1]);
+        }
+        break;
+    }
+}
+
+//top row first, the same way up as the simulator draws it
+static void draw(const viewState &view)
+{
+    static const char *arrows[4] = {">", "v", "<", "^"};
+    std::string out = "\033[H\033[2J";
+    for(int y = view.height-1; y >= 0; y--)
+    {
+        for(int x = 0; x < view.width; x++)
+        {
+            out += (view.cell(x, y) >> dUP) & 1 ? "+--" : "+  ";
+        }
+        out += "+\n";
+        for(int x = 0; x < view.width; x++)
+        {
+            out += (view.cell(x, y) >> dLEFT) & 1 ? "|" : " ";
+            if(x+1 == view.x && y+1 == view.y)
+            {
+                out += std::string(" ") + arrows[view.dir];
+            }
+            else
+            {
+                out += view.cell(x, y) & GOAL_FLAG ? "::" : "  ";
+            }
+        }
+        out += view.width && (view.cell(view.width-1, y) >> dRIGHT) & 1 ? "|\n" : "\n";
+    }
+    for(int x = 0; x < view.width; x++)
+    {
+        out += (view.cell(x, 0) >> dDOWN) & 1 ? "+--" : "+  ";
+    }
+    out += "+\n";
+    for(size_t i = 0; i < view.log.size(); i++)
+    {
+        out += view.log[i] + "\n";
+    }
+    fputs(out.c_str(), stdout);
+    fflush(stdout);
+}
+
+int main(int argc, char *argv[])
+{
+    std::string path = SPECTATOR_PATH;
+    bool events = false;
+    for(int i = 1; i < argc; i++)
+    {
+        if(!strcmp(argv[i], "--events"))
+        {
+            events = true;
+        }
+        else if(argv[i][0] == '-')
+        {
+            fprintf(stderr, "usage: %s [--events] [socket (default %s)]\n", argv[0], SPECTATOR_PATH);
+            return 2;
+        }
+        else
+        {
+            path = argv[i];
+        }
+    }
+
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if(fd < 0 || connect(fd, (sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        fprintf(stderr, "ERROR 210: could not connect to %s: %s\n", path.c_str(), strerror(errno));
+        return 1;
+    }
+
+    viewState view;
+    std::string buf;
+    char chunk[4096];
+    for(ssize_t got = recv(fd, chunk, sizeof(chunk), 0); got > 0; got = recv(fd, chunk, sizeof(chunk), 0))
+    {
+        buf.append(chunk, got);
+        size_t used = 0;
+        while(used < buf.size())
+        {
+            long len = messageLength(buf.substr(used, 10));
+            if(len < 0)
+            {
+                fprintf(stderr, "ERROR 211: unknown message '%c' in the stream\n", buf[used]);
+                close(fd);
+                return 1;
+            }
+            if(len == 0 || used + len > buf.size())
+            {
+                break;
+            }
+            apply(view, buf.data() + used, events);
+            used += len;
+        }
+        buf.erase(0, used);
+
+        //one redraw per read, however many moves it held
+        if(!events && view.width)
+        {
+            draw(view);
+        }
+        else if(events)
+        {
+            fflush(stdout);
+        }
+    }
+    close(fd);
+    return 0;
+}